@@ -8,6 +8,9 @@
 
 #include <fplus/composition.hpp>
 #include <fplus/container_traits.hpp>
+#include <fplus/flat_containers.hpp>
+#include <fplus/instrument.hpp>
+#include <fplus/views.hpp>
 #include <fplus/maybe.hpp>
 #include <fplus/compare.hpp>
 
@@ -20,14 +23,34 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
 #include <iterator>
+#include <limits>
 #include <numeric>
+#include <string>
+#include <thread>
 
 namespace fplus
 {
 
 namespace internal
 {
+    // Elements of a container that may be reused are moved out of it,
+    // all others are copied.
+    template <typename T>
+    const T& forward_elem(create_new_container_t, const T& x)
+    {
+        return x;
+    }
+
+    template <typename T>
+    T&& forward_elem(reuse_container_t, T& x)
+    {
+        return std::move(x);
+    }
+
     template <typename UnaryPredicate, typename Container>
     void check_unary_predicate_for_container()
     {
@@ -110,6 +133,34 @@ namespace internal
     {
     }
 
+    template <typename Container, typename = void>
+    struct has_size_member : std::false_type {};
+    template <typename Container>
+    struct has_size_member<Container, detail::void_t<
+        decltype(std::declval<const Container&>().size())>> :
+        std::true_type {};
+
+    template <typename Container>
+    std::size_t size_hint(std::true_type, const Container& xs)
+    {
+        return xs.size();
+    }
+
+    template <typename Container>
+    std::size_t size_hint(std::false_type, const Container&)
+    {
+        return 0;
+    }
+
+    // Number of elements to prepare an output container for.
+    // Single-pass ranges (e.g. text_file_lines) do not know their size,
+    // and counting them would consume them, so they give 0.
+    template <typename Container>
+    std::size_t size_hint(const Container& xs)
+    {
+        return size_hint(has_size_member<Container>(), xs);
+    }
+
     template <typename Container>
     std::back_insert_iterator<Container> get_back_inserter(std::string& ys)
     {
@@ -213,6 +264,12 @@ namespace internal
         return std::next(it,
             static_cast<typename Iterator::difference_type>(distance));
     }
+
+    template <typename Container>
+    using is_random_access_cont = std::is_base_of<
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<
+            typename Container::iterator>::iterator_category>;
 } // namespace internal
 
 // API search type: is_empty : [a] -> Bool
@@ -293,12 +350,24 @@ ContainerOut convert_container(const ContainerIn& xs)
     static_assert(std::is_same<DestElem, SourceElem>::value,
         "Source and dest container must have the same value_type");
     ContainerOut ys;
-    internal::prepare_container(ys, size_of_cont(xs));
+    internal::prepare_container(ys, internal::size_hint(xs));
     auto itOut = internal::get_back_inserter<ContainerOut>(ys);
     std::copy(std::begin(xs), std::end(xs), itOut);
     return ys;
 }
 
+// API search type: materialize : [a] -> [a]
+// fwd bind count: 0
+// Copies the elements of a lazy view, e.g. one returned by numbers_lazy,
+// into an std::vector. Other containers are just copied.
+// materialize(numbers_lazy(2, 5)) == [2, 3, 4]
+template <typename Container,
+    typename ContainerOut = internal::materialized_t<Container>>
+ContainerOut materialize(const Container& xs)
+{
+    return convert_container<ContainerOut>(xs);
+}
+
 // API search type: convert_container_and_elems : [a] -> [b]
 // fwd bind count: 0
 // Converts between different containers and elements.
@@ -330,11 +399,12 @@ Container get_segment(internal::reuse_container_t,
 {
     assert(idx_begin <= idx_end);
     assert(idx_end <= size_of_cont(xs));
+    auto itEnd = std::begin(xs);
+    internal::advance_iterator(itEnd, idx_end);
+    xs.erase(itEnd, std::end(xs));
     auto itBegin = std::begin(xs);
     internal::advance_iterator(itBegin, idx_begin);
-    auto itEnd = itBegin;
-    internal::advance_iterator(itEnd, idx_end - idx_begin);
-    xs.erase(std::copy(itBegin, itEnd, std::begin(xs)), std::end(xs));
+    xs.erase(std::begin(xs), itBegin);
     return std::forward<Container>(xs);
 }
 
@@ -345,6 +415,7 @@ Container get_segment(internal::create_new_container_t,
     assert(idx_begin <= idx_end);
     assert(idx_end <= size_of_cont(xs));
     Container result;
+    internal::prepare_container(result, idx_end - idx_begin);
     auto itBegin = std::begin(xs);
     internal::advance_iterator(itBegin, idx_begin);
     auto itEnd = itBegin;
@@ -366,6 +437,7 @@ template <typename Container,
 ContainerOut get_segment
         (std::size_t idx_begin, std::size_t idx_end, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("get_segment", Container, xs);
     return internal::get_segment(internal::can_reuse_v<Container>{},
         idx_begin, idx_end, std::forward<Container>(xs));
 }
@@ -406,6 +478,7 @@ template <typename ContainerToken, typename Container,
 ContainerOut set_segment
         (std::size_t idx_begin, const ContainerToken& token, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("set_segment", Container, xs);
     return internal::set_segment(internal::can_reuse_v<Container>{},
         idx_begin, token, std::forward<Container>(xs));
 }
@@ -423,11 +496,10 @@ Container remove_segment(internal::reuse_container_t,
     auto firstBreakIt = std::begin(xs);
     internal::advance_iterator(firstBreakIt, idx_begin);
 
-    auto secondBreakIt = std::begin(xs);
-    internal::advance_iterator(secondBreakIt, idx_end);
+    auto secondBreakIt = firstBreakIt;
+    internal::advance_iterator(secondBreakIt, idx_end - idx_begin);
 
-    xs.erase(
-        std::copy(secondBreakIt, std::end(xs), firstBreakIt), std::end(xs));
+    xs.erase(firstBreakIt, secondBreakIt);
     return std::forward<Container>(xs);
 }
 
@@ -465,6 +537,7 @@ template <typename Container,
 ContainerOut remove_segment(
         std::size_t idx_begin, std::size_t idx_end, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("remove_segment", Container, xs);
     return internal::remove_segment(internal::can_reuse_v<Container>{},
         idx_begin, idx_end, std::forward<Container>(xs));
 }
@@ -526,10 +599,63 @@ maybe<T> elem_at_idx_maybe(std::size_t idx, const Container& xs)
     return *it;
 }
 
+namespace internal
+{
+
+template <typename T, typename ContainerIdxs, typename Container>
+std::vector<T> elems_at_idxs(std::true_type,
+    const ContainerIdxs& idxs, const Container& xs)
+{
+    std::vector<T> result;
+    result.reserve(size_of_cont(idxs));
+    for (std::size_t idx : idxs)
+    {
+        assert(idx < size_of_cont(xs));
+        result.push_back(*internal::add_to_iterator(std::begin(xs), idx));
+    }
+    return result;
+}
+
+// Visits the requested positions in ascending order,
+// so that xs is traversed only once.
+template <typename T, typename ContainerIdxs, typename Container>
+std::vector<T> elems_at_idxs(std::false_type,
+    const ContainerIdxs& idxs, const Container& xs)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> idxs_and_positions;
+    idxs_and_positions.reserve(size_of_cont(idxs));
+    for (std::size_t idx : idxs)
+    {
+        assert(idx < size_of_cont(xs));
+        idxs_and_positions.emplace_back(idx, idxs_and_positions.size());
+    }
+    std::sort(std::begin(idxs_and_positions), std::end(idxs_and_positions));
+    std::vector<typename Container::const_iterator> its(
+        idxs_and_positions.size());
+    auto it = std::begin(xs);
+    std::size_t it_idx = 0;
+    for (const auto& idx_and_position : idxs_and_positions)
+    {
+        internal::advance_iterator(it, idx_and_position.first - it_idx);
+        it_idx = idx_and_position.first;
+        its[idx_and_position.second] = it;
+    }
+    std::vector<T> result;
+    result.reserve(its.size());
+    for (const auto& elem_it : its)
+    {
+        result.push_back(*elem_it);
+    }
+    return result;
+}
+
+} // namespace internal
+
 // API search type: elems_at_idxs : ([Int], [a]) -> [a]
 // fwd bind count: 1
 // Construct a subsequence from the elements with the given indices.
 // elem_at_idxs([1, 3], [7,6,5,4,3]) == [6, 4]
+// Containers without random access are traversed only once.
 template <typename Container,
     typename ContainerIdxs,
     typename T = typename Container::value_type,
@@ -538,14 +664,8 @@ std::vector<T> elems_at_idxs(const ContainerIdxs& idxs, const Container& xs)
 {
     static_assert(std::is_same<typename ContainerIdxs::value_type, std::size_t>::value,
         "Indices must be std::size_t");
-    ContainerOut result;
-    internal::prepare_container(result, size_of_cont(idxs));
-    auto itOut = internal::get_back_inserter(result);
-    for (std::size_t idx : idxs)
-    {
-        *itOut = elem_at_idx(idx, xs);
-    }
-    return result;
+    return internal::elems_at_idxs<T>(
+        internal::is_random_access_cont<Container>{}, idxs, xs);
 }
 
 namespace internal
@@ -569,7 +689,7 @@ ContainerOut transform(internal::create_new_container_t, F f,
                                          F,
                                          decltype(*std::begin(xs))>();
     ContainerOut ys;
-    internal::prepare_container(ys, size_of_cont(xs));
+    internal::prepare_container(ys, internal::size_hint(xs));
     auto it = internal::get_back_inserter<ContainerOut>(ys);
     std::transform(std::begin(xs), std::end(xs), it, f);
     return ys;
@@ -587,6 +707,7 @@ template <typename F, typename ContainerIn,
         internal::remove_const_and_ref_t<ContainerIn>, F, 0>::type>
 ContainerOut transform(F f, ContainerIn&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("transform", ContainerIn, xs);
     using reuse_t = typename std::conditional<
         std::is_same<
             internal::can_reuse_v<ContainerIn>,
@@ -674,6 +795,7 @@ template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut reverse(Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("reverse", Container, xs);
     return internal::reverse(internal::can_reuse_v<Container>{},
         std::forward<Container>(xs));
 }
@@ -688,8 +810,9 @@ template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut take(std::size_t amount, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("take", Container, xs);
     if (amount >= size_of_cont(xs))
-        return xs;
+        return std::forward<Container>(xs);
     return get_segment(0, amount, std::forward<Container>(xs));
 }
 
@@ -750,6 +873,7 @@ template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut drop(std::size_t amount, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("drop", Container, xs);
     if (amount >= size_of_cont(xs))
         return ContainerOut();
     return get_segment(amount, size_of_cont(xs), std::forward<Container>(xs));
@@ -766,7 +890,7 @@ template <typename Container,
 ContainerOut take_last(std::size_t amount, Container&& xs)
 {
     if (amount >= size_of_cont(xs))
-        return xs;
+        return std::forward<Container>(xs);
     return drop(size_of_cont(xs) - amount, std::forward<Container>(xs));
 }
 
@@ -797,20 +921,59 @@ ContainerOut drop_exact(std::size_t amount, Container&& xs)
     return get_segment(amount, size_of_cont(xs), std::forward<Container>(xs));
 }
 
+namespace internal
+{
+
+template <typename UnaryPredicate, typename Container>
+Container take_while(internal::reuse_container_t,
+    UnaryPredicate pred, Container&& xs)
+{
+    xs.erase(std::find_if_not(std::begin(xs), std::end(xs), pred),
+        std::end(xs));
+    return std::forward<Container>(xs);
+}
+
+template <typename UnaryPredicate, typename Container>
+Container take_while(internal::create_new_container_t,
+    UnaryPredicate pred, const Container& xs)
+{
+    return Container(std::begin(xs),
+        std::find_if_not(std::begin(xs), std::end(xs), pred));
+}
+
+template <typename UnaryPredicate, typename Container>
+Container drop_while(internal::reuse_container_t,
+    UnaryPredicate pred, Container&& xs)
+{
+    xs.erase(std::begin(xs),
+        std::find_if_not(std::begin(xs), std::end(xs), pred));
+    return std::forward<Container>(xs);
+}
+
+template <typename UnaryPredicate, typename Container>
+Container drop_while(internal::create_new_container_t,
+    UnaryPredicate pred, const Container& xs)
+{
+    return Container(
+        std::find_if_not(std::begin(xs), std::end(xs), pred), std::end(xs));
+}
+
+} // namespace internal
+
 // API search type: take_while : ((a -> Bool), [a]) -> [a]
 // fwd bind count: 1
 // Take elements from the beginning of a sequence
 // as long as they are fulfilling a predicate.
 // take_while(is_even, [0,2,4,5,6,7,8]) == [0,2,4]
-template <typename Container, typename UnaryPredicate>
-Container take_while(UnaryPredicate pred, const Container& xs)
+template <typename Container, typename UnaryPredicate,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut take_while(UnaryPredicate pred, Container&& xs)
 {
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    auto itFirst = std::find_if(
-        std::begin(xs), std::end(xs), logical_not(pred));
-    if (itFirst == std::end(xs))
-        return xs;
-    return Container(std::begin(xs), itFirst);
+    FPLUS_INSTRUMENT_CALL("take_while", Container, xs);
+    internal::check_unary_predicate_for_container<
+        UnaryPredicate, ContainerOut>();
+    return internal::take_while(internal::can_reuse_v<Container>{},
+        pred, std::forward<Container>(xs));
 }
 
 // API search type: drop_while : ((a -> Bool), [a]) -> [a]
@@ -819,14 +982,15 @@ Container take_while(UnaryPredicate pred, const Container& xs)
 // as long as they are fulfilling a predicate.
 // drop_while(is_even, [0,2,4,5,6,7,8]) == [5,6,7,8]
 // Also known as trim_left_by.
-template <typename Container, typename UnaryPredicate>
-Container drop_while(UnaryPredicate pred, const Container& xs)
+template <typename Container, typename UnaryPredicate,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut drop_while(UnaryPredicate pred, Container&& xs)
 {
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    auto itFirstNot = std::find_if_not(std::begin(xs), std::end(xs), pred);
-    if (itFirstNot == std::end(xs))
-        return Container();
-    return Container(itFirstNot, std::end(xs));
+    FPLUS_INSTRUMENT_CALL("drop_while", Container, xs);
+    internal::check_unary_predicate_for_container<
+        UnaryPredicate, ContainerOut>();
+    return internal::drop_while(internal::can_reuse_v<Container>{},
+        pred, std::forward<Container>(xs));
 }
 
 // API search type: fold_left : (((a, b) -> a), a, [b]) -> a
@@ -1006,19 +1170,300 @@ ContainerOut scan_right_1(F f, const ContainerIn& xs)
     return reverse(scan_left_1(flip(f), reverse(xs)));
 }
 
+namespace internal
+{
+    // Contiguous containers of arithmetic values are reduced
+    // using several independent accumulators ("lanes").
+    // This breaks the dependency chain between consecutive additions,
+    // so the loop can be pipelined and vectorized by the compiler
+    // even without -ffast-math.
+    // For floating-point values this changes the order of the operations,
+    // so the result can differ in the last bits
+    // from a strictly sequential accumulation.
+    // Since the order is fixed, the result is still deterministic
+    // across platforms.
+    // Integers are accumulated as unsigned values to avoid
+    // undefined behavior in intermediate lane sums,
+    // giving the same result as the sequential loop.
+    template <typename Container>
+    struct is_contiguous_arithmetic : public std::false_type {};
+
+    template <typename T, typename A>
+    struct is_contiguous_arithmetic<std::vector<T, A>> :
+        public std::integral_constant<bool,
+            std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> {};
+
+    template <typename T, std::size_t N>
+    struct is_contiguous_arithmetic<std::array<T, N>> :
+        public std::integral_constant<bool,
+            std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> {};
+
+    template <typename T, typename Container>
+    using use_lane_kernel = std::integral_constant<bool,
+        is_contiguous_arithmetic<Container>::value &&
+        std::is_same<T, typename Container::value_type>::value>;
+
+    // Small integer types are widened to unsigned int,
+    // because they would be promoted to (signed) int otherwise.
+    template <typename T, bool = std::is_integral<T>::value>
+    struct lane_acc
+    {
+        typedef T type;
+    };
+
+    template <typename T>
+    struct lane_acc<T, true>
+    {
+        typedef std::common_type_t<std::make_unsigned_t<T>, unsigned int> type;
+    };
+
+    template <typename T>
+    using lane_acc_t = typename lane_acc<T>::type;
+
+    constexpr std::size_t reduce_lane_count = 8;
+
+    // op(acc, idx) must update acc with the element(s) at index idx.
+    template <typename T, typename Op>
+    T reduce_lanes(std::size_t size, T init, lane_acc_t<T> neutral, Op op)
+    {
+        typedef lane_acc_t<T> Acc;
+        Acc lanes[reduce_lane_count];
+        std::fill(std::begin(lanes), std::end(lanes), neutral);
+        const std::size_t size_lanes = size - size % reduce_lane_count;
+        std::size_t i = 0;
+        for (; i < size_lanes; i += reduce_lane_count)
+        {
+            for (std::size_t j = 0; j < reduce_lane_count; ++j)
+            {
+                op(lanes[j], i + j);
+            }
+        }
+        for (; i < size; ++i)
+        {
+            op(lanes[0], i);
+        }
+        return static_cast<T>(op.combine(static_cast<Acc>(init),
+            op.combine(
+                op.combine(op.combine(lanes[0], lanes[1]),
+                    op.combine(lanes[2], lanes[3])),
+                op.combine(op.combine(lanes[4], lanes[5]),
+                    op.combine(lanes[6], lanes[7])))));
+    }
+
+    template <typename T>
+    struct sum_lane_op
+    {
+        typedef lane_acc_t<T> Acc;
+        const T* xs;
+        void operator()(Acc& acc, std::size_t idx) const
+        {
+            acc = static_cast<Acc>(acc + static_cast<Acc>(xs[idx]));
+        }
+        Acc combine(Acc a, Acc b) const { return static_cast<Acc>(a + b); }
+    };
+
+    template <typename T>
+    struct product_lane_op
+    {
+        typedef lane_acc_t<T> Acc;
+        const T* xs;
+        void operator()(Acc& acc, std::size_t idx) const
+        {
+            acc = static_cast<Acc>(acc * static_cast<Acc>(xs[idx]));
+        }
+        Acc combine(Acc a, Acc b) const { return static_cast<Acc>(a * b); }
+    };
+
+    template <typename T, typename Container>
+    T sum(std::true_type, const Container& xs)
+    {
+        return reduce_lanes<T>(size_of_cont(xs), T(), lane_acc_t<T>(),
+            sum_lane_op<T>{xs.data()});
+    }
+
+    template <typename T, typename Container>
+    T sum(std::false_type, const Container& xs)
+    {
+        T result = T();
+        for (const auto& x : xs)
+        {
+            result = result + x;
+        }
+        return result;
+    }
+
+    template <typename T, typename Container>
+    T product(std::true_type, const Container& xs)
+    {
+        return reduce_lanes<T>(size_of_cont(xs), T(1), lane_acc_t<T>(1),
+            product_lane_op<T>{xs.data()});
+    }
+
+    template <typename T, typename Container>
+    T product(std::false_type, const Container& xs)
+    {
+        T result{1};
+        for (const auto& x : xs)
+        {
+            result = result * x;
+        }
+        return result;
+    }
+
+    // Searches the minimum and the maximum of contiguous arithmetic values
+    // in one pass, see minimum and maximum in container_properties.hpp.
+    template <typename T>
+    std::pair<T, T> lane_minmax(const T* xs, std::size_t size)
+    {
+        assert(size != 0);
+        T mins[reduce_lane_count];
+        T maxs[reduce_lane_count];
+        std::fill(std::begin(mins), std::end(mins), xs[0]);
+        std::fill(std::begin(maxs), std::end(maxs), xs[0]);
+        const std::size_t size_lanes = size - size % reduce_lane_count;
+        std::size_t i = 0;
+        for (; i < size_lanes; i += reduce_lane_count)
+        {
+            for (std::size_t j = 0; j < reduce_lane_count; ++j)
+            {
+                const T x = xs[i + j];
+                mins[j] = x < mins[j] ? x : mins[j];
+                maxs[j] = maxs[j] < x ? x : maxs[j];
+            }
+        }
+        for (; i < size; ++i)
+        {
+            mins[0] = xs[i] < mins[0] ? xs[i] : mins[0];
+            maxs[0] = maxs[0] < xs[i] ? xs[i] : maxs[0];
+        }
+        T x_min = mins[0];
+        T x_max = maxs[0];
+        for (std::size_t j = 1; j < reduce_lane_count; ++j)
+        {
+            x_min = mins[j] < x_min ? mins[j] : x_min;
+            x_max = x_max < maxs[j] ? maxs[j] : x_max;
+        }
+        return std::make_pair(x_min, x_max);
+    }
+
+    template <typename Container,
+        typename T = typename Container::value_type>
+    std::pair<T, T> minmax(std::true_type, const Container& xs)
+    {
+        return lane_minmax(xs.data(), size_of_cont(xs));
+    }
+
+    template <typename Container,
+        typename T = typename Container::value_type>
+    std::pair<T, T> minmax(std::false_type, const Container& xs)
+    {
+        assert(is_not_empty(xs));
+        auto it = std::begin(xs);
+        auto it_min = it;
+        auto it_max = it;
+        for (++it; it != std::end(xs); ++it)
+        {
+            if (*it < *it_min)
+                it_min = it;
+            if (*it_max < *it)
+                it_max = it;
+        }
+        return std::make_pair(*it_min, *it_max);
+    }
+} // namespace internal
+
 // API search type: sum : [a] -> a
 // fwd bind count: 0
 // Adds up all values in a sequence.
 // sum([0,3,1]) == 4
 // sum([]) == 0
+// Arithmetic values in std::vector and std::array are summed up
+// using eight interleaved accumulators, which is much faster,
+// but for floating-point values the rounding can differ
+// from a sequential summation.
+// See sum_kahan and sum_pairwise for more accurate alternatives.
 template <typename Container,
     typename T = typename Container::value_type>
 T sum(const Container& xs)
 {
+    FPLUS_INSTRUMENT_CALL("sum", const Container&, xs);
+    return internal::sum<T>(internal::use_lane_kernel<T, Container>(), xs);
+}
+
+// API search type: sum_kahan : [a] -> a
+// fwd bind count: 0
+// Adds up all values in a sequence
+// using compensated (Kahan-Babuska-Neumaier) summation.
+// The rounding error does not grow with the number of elements,
+// so the result is accurate even when summing values
+// of very different magnitudes.
+// sum_kahan([1e100, 1.0, -1e100]) == 1.0
+// sum_kahan([]) == 0
+// Do not compile with -ffast-math, it optimizes the compensation away.
+template <typename Container,
+    typename T = typename Container::value_type>
+T sum_kahan(const Container& xs)
+{
+    static_assert(std::is_floating_point<T>::value,
+        "Please use a floating-point type.");
     T result = T();
+    T compensation = T();
     for (const auto& x : xs)
     {
-        result = result + x;
+        const T t = result + x;
+        if (std::abs(result) >= std::abs(x))
+            compensation = compensation + ((result - t) + x);
+        else
+            compensation = compensation + ((x - t) + result);
+        result = t;
+    }
+    return result + compensation;
+}
+
+// API search type: sum_pairwise : [a] -> a
+// fwd bind count: 0
+// Adds up all values in a sequence using pairwise (cascade) summation.
+// The rounding error only grows logarithmically
+// with the number of elements, at nearly the speed of sum.
+// The result is independent of the platform.
+// sum_pairwise([0,3,1]) == 4
+// sum_pairwise([]) == 0
+template <typename Container,
+    typename T = typename Container::value_type>
+T sum_pairwise(const Container& xs)
+{
+    // Blocks are summed up sequentially, and the block sums are combined
+    // like the digits of a binary counter, forming a balanced tree.
+    const std::size_t block_size = 128;
+    T levels[64];
+    std::size_t block_count = 0;
+    auto it = std::begin(xs);
+    const auto it_end = std::end(xs);
+    while (it != it_end)
+    {
+        T block = T();
+        for (std::size_t i = 0; i < block_size && it != it_end; ++i, ++it)
+        {
+            block = block + *it;
+        }
+        std::size_t level = 0;
+        for (std::size_t carry = block_count; carry % 2 == 1; carry /= 2)
+        {
+            block = levels[level] + block;
+            ++level;
+        }
+        levels[level] = block;
+        ++block_count;
+    }
+    T result = T();
+    bool is_first = true;
+    for (std::size_t level = 0; block_count != 0; ++level, block_count /= 2)
+    {
+        if (block_count % 2 == 1)
+        {
+            result = is_first ? levels[level] : levels[level] + result;
+            is_first = false;
+        }
     }
     return result;
 }
@@ -1028,16 +1473,14 @@ T sum(const Container& xs)
 // Returns the product of all values in a sequence.
 // product([3,1,2]) == 6
 // product([]) == 1
+// Like sum, arithmetic values in std::vector and std::array
+// are multiplied using multiple accumulators.
 template <typename Container,
     typename T = typename Container::value_type>
 T product(const Container& xs)
 {
-    T result{1};
-    for (const auto& x : xs)
-    {
-        result = result * x;
-    }
-    return result;
+    return internal::product<T>(
+        internal::use_lane_kernel<T, Container>(), xs);
 }
 
 namespace internal
@@ -1073,6 +1516,7 @@ template <typename Container,
     typename T = typename ContainerOut::value_type>
 ContainerOut append_elem(const T& y, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("append_elem", Container, xs);
     return internal::append_elem(internal::can_reuse_v<Container>{},
         y, std::forward<Container>(xs));
 }
@@ -1121,6 +1565,7 @@ template <typename Container,
     typename T = typename ContainerOut::value_type>
 ContainerOut prepend_elem(const T& y, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("prepend_elem", Container, xs);
     return internal::prepend_elem(internal::can_reuse_v<Container>{},
         y, std::forward<Container>(xs));
 }
@@ -1150,6 +1595,7 @@ template <typename ContainerIn,
     typename ContainerOut = typename ContainerIn::value_type>
 ContainerOut concat(const ContainerIn& xss)
 {
+    FPLUS_INSTRUMENT_CALL("concat", const ContainerIn&, xss);
     std::size_t length = sum(
         transform(size_of_cont<typename ContainerIn::value_type>, xss));
     ContainerOut result;
@@ -1216,6 +1662,291 @@ std::pair<Container, Container> unweave(const Container& xs)
     return result;
 }
 
+namespace internal
+{
+    // Maps arithmetic values to unsigned integers of the same order,
+    // so they can be sorted digit by digit.
+    template <typename T, typename = void>
+    struct radix_key
+    {
+        typedef std::make_unsigned_t<T> type;
+        static type get(T x)
+        {
+            const type sign_bit = std::is_signed<T>::value
+                ? static_cast<type>(type(1) << (8 * sizeof(T) - 1))
+                : type(0);
+            return static_cast<type>(static_cast<type>(x) ^ sign_bit);
+        }
+    };
+
+    template <typename T, typename Bits>
+    Bits floating_point_radix_key(T x)
+    {
+        static_assert(sizeof(T) == sizeof(Bits), "Unexpected size.");
+        Bits bits;
+        std::memcpy(&bits, &x, sizeof(T));
+        const Bits sign_bit = Bits(1) << (8 * sizeof(T) - 1);
+        return (bits & sign_bit) ? static_cast<Bits>(~bits) : (bits | sign_bit);
+    }
+
+    template <>
+    struct radix_key<float>
+    {
+        typedef std::uint32_t type;
+        static type get(float x)
+        {
+            return floating_point_radix_key<float, type>(x);
+        }
+    };
+
+    template <>
+    struct radix_key<double>
+    {
+        typedef std::uint64_t type;
+        static type get(double x)
+        {
+            return floating_point_radix_key<double, type>(x);
+        }
+    };
+
+    template <typename T>
+    using is_radix_sortable = std::integral_constant<bool,
+        (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+        (std::is_same<T, float>::value &&
+            std::numeric_limits<float>::is_iec559) ||
+        (std::is_same<T, double>::value &&
+            std::numeric_limits<double>::is_iec559)>;
+
+    // Below this size, comparison sorts are faster.
+    constexpr std::size_t radix_sort_min_size = 256;
+
+    // Stable LSD radix sort.
+    // Keys of at least 32 bits use 11-bit digits (fewer passes),
+    // smaller keys use 8-bit digits.
+    // The counts of all digits are collected in one pass,
+    // and digits that are equal for all elements are skipped.
+    template <typename Item, typename KeyF>
+    void radix_sort(Item* items, std::size_t size, KeyF key_of)
+    {
+        typedef std::decay_t<decltype(key_of(*items))> Key;
+        const std::size_t digit_bits = sizeof(Key) >= 4 ? 11 : 8;
+        const std::size_t radix = std::size_t(1) << digit_bits;
+        const Key digit_mask = static_cast<Key>(radix - 1);
+        const std::size_t digit_count =
+            (8 * sizeof(Key) + digit_bits - 1) / digit_bits;
+        const auto digit_of = [&](const Key& key, std::size_t d)
+        {
+            return static_cast<std::size_t>((key >> (digit_bits * d)) &
+                digit_mask);
+        };
+        std::vector<std::size_t> counts(digit_count * radix, 0);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const Key key = key_of(items[i]);
+            for (std::size_t d = 0; d < digit_count; ++d)
+            {
+                ++counts[d * radix + digit_of(key, d)];
+            }
+        }
+        std::vector<Item> buffer;
+        Item* src = items;
+        Item* dst = nullptr;
+        for (std::size_t d = 0; d < digit_count; ++d)
+        {
+            std::size_t* digit_counts = counts.data() + d * radix;
+            if (digit_counts[digit_of(key_of(src[0]), d)] == size)
+                continue;
+            if (dst == nullptr)
+            {
+                buffer.resize(size);
+                dst = buffer.data();
+            }
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < radix; ++i)
+            {
+                const std::size_t count = digit_counts[i];
+                digit_counts[i] = offset;
+                offset += count;
+            }
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                dst[digit_counts[digit_of(key_of(src[i]), d)]++] =
+                    std::move(src[i]);
+            }
+            std::swap(src, dst);
+        }
+        if (src != items)
+        {
+            std::move(src, src + size, items);
+        }
+    }
+
+    template <typename T>
+    void radix_sort_values(T* xs, std::size_t size)
+    {
+        if (size < radix_sort_min_size)
+            std::sort(xs, xs + size);
+        else
+            radix_sort(xs, size, [](T x) { return radix_key<T>::get(x); });
+    }
+
+    inline std::size_t log2_floor(std::size_t x)
+    {
+        std::size_t result = 0;
+        while (x > 1)
+        {
+            x /= 2;
+            ++result;
+        }
+        return result;
+    }
+
+    // Compares two sequences by their digits from depth on.
+    template <typename DigitF, typename T>
+    bool is_less_from_depth(DigitF digit_of, std::size_t depth,
+        const T& x, const T& y)
+    {
+        for (std::size_t d = depth;; ++d)
+        {
+            const auto digit_x = digit_of(x, d);
+            const auto digit_y = digit_of(y, d);
+            if (digit_x < digit_y)
+                return true;
+            if (digit_y < digit_x || !digit_x.first)
+                return false;
+        }
+    }
+
+    // Multikey quicksort (Bentley, Sedgewick) for sequences,
+    // comparing one element position (depth) at a time.
+    // The digit of a sequence at a position beyond its end
+    // is smaller than all others.
+    // Only the two smaller of the three partitions are sorted recursively,
+    // so the recursion depth is O(log(n)).
+    // Like in introsort, a range that needed more than budget
+    // partitioning steps without advancing depth is sorted by std::sort,
+    // which bounds the run time by O(n*log(n)) comparisons.
+    template <typename DigitF, typename RandomIt>
+    void multikey_quicksort(RandomIt first, RandomIt last,
+        std::size_t depth, DigitF digit_of, std::size_t budget)
+    {
+        typedef typename std::iterator_traits<RandomIt>::value_type T;
+        while (std::distance(first, last) > 16)
+        {
+            if (budget == 0)
+            {
+                std::sort(first, last, [&](const T& x, const T& y)
+                {
+                    return is_less_from_depth(digit_of, depth, x, y);
+                });
+                return;
+            }
+            const auto pivot = digit_of(
+                *(first + std::distance(first, last) / 2), depth);
+            // [first, lt) < pivot, [lt, i) == pivot, [gt, last) > pivot
+            RandomIt lt = first;
+            RandomIt i = first;
+            RandomIt gt = last;
+            while (i != gt)
+            {
+                const auto digit = digit_of(*i, depth);
+                if (digit < pivot)
+                {
+                    std::iter_swap(lt, i);
+                    ++lt;
+                    ++i;
+                }
+                else if (pivot < digit)
+                {
+                    --gt;
+                    std::iter_swap(i, gt);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+            --budget;
+            // Sequences ending at depth are equal and thus already sorted.
+            const auto size_lt = std::distance(first, lt);
+            const auto size_eq = pivot.first ? std::distance(lt, gt) : 0;
+            const auto size_gt = std::distance(gt, last);
+            if (pivot.first && size_eq >= size_lt && size_eq >= size_gt)
+            {
+                multikey_quicksort(first, lt, depth, digit_of, budget);
+                multikey_quicksort(gt, last, depth, digit_of, budget);
+                first = lt;
+                last = gt;
+                ++depth;
+                budget = 2 * log2_floor(
+                    static_cast<std::size_t>(size_eq)) + 1;
+            }
+            else
+            {
+                if (size_eq > 0)
+                {
+                    multikey_quicksort(lt, gt, depth + 1, digit_of,
+                        2 * log2_floor(
+                            static_cast<std::size_t>(size_eq)) + 1);
+                }
+                if (size_lt >= size_gt)
+                {
+                    multikey_quicksort(gt, last, depth, digit_of, budget);
+                    last = lt;
+                }
+                else
+                {
+                    multikey_quicksort(first, lt, depth, digit_of, budget);
+                    first = gt;
+                }
+            }
+        }
+        // Insertion sort for small ranges, comparing from depth on.
+        for (RandomIt it = first; it != last; ++it)
+        {
+            for (RandomIt it_back = it; it_back != first &&
+                is_less_from_depth(digit_of, depth,
+                    *it_back, *(it_back - 1)); --it_back)
+            {
+                std::iter_swap(it_back, it_back - 1);
+            }
+        }
+    }
+
+    template <typename DigitF, typename RandomIt>
+    void multikey_quicksort(RandomIt first, RandomIt last,
+        std::size_t depth, DigitF digit_of)
+    {
+        const auto size = static_cast<std::size_t>(std::distance(first, last));
+        multikey_quicksort(first, last, depth, digit_of,
+            2 * log2_floor(size) + 1);
+    }
+
+    // std::basic_string<char> compares its elements as unsigned char.
+    struct string_digit
+    {
+        std::pair<bool, unsigned char> operator()(
+            const std::string& str, std::size_t depth) const
+        {
+            return depth < str.size()
+                ? std::make_pair(true, static_cast<unsigned char>(str[depth]))
+                : std::make_pair(false, static_cast<unsigned char>(0));
+        }
+    };
+
+    template <typename Container,
+        typename T = typename Container::value_type>
+    using use_radix_sort = std::integral_constant<bool,
+        is_contiguous_arithmetic<Container>::value &&
+        is_radix_sortable<T>::value>;
+
+    template <typename Container,
+        typename T = typename Container::value_type>
+    using use_string_sort = std::integral_constant<bool,
+        is_random_access_cont<Container>::value &&
+        std::is_same<T, std::string>::value>;
+} // namespace internal
+
 namespace internal
 {
 
@@ -1261,6 +1992,7 @@ template <typename Compare, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut sort_by(Compare comp, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("sort_by", Container, xs);
     return internal::sort_by(internal::can_reuse_v<Container>{},
         comp, std::forward<Container>(xs));
 }
@@ -1296,26 +2028,157 @@ namespace internal
     };
 }
 
+namespace internal
+{
+    template <typename ContainerOut, typename Container>
+    ContainerOut sort(std::integral_constant<int, 0>, Container&& xs)
+    {
+        typedef typename ContainerOut::value_type T;
+        return fplus::sort_by(std::less<T>(), std::forward<Container>(xs));
+    }
+
+    template <typename ContainerOut, typename Container>
+    ContainerOut sort(std::integral_constant<int, 1>, Container&& xs)
+    {
+        ContainerOut ys = std::forward<Container>(xs);
+        radix_sort_values(ys.data(), size_of_cont(ys));
+        return ys;
+    }
+
+    // The strings are sorted as pointers, which are cheaper to swap,
+    // and moved into place afterwards.
+    template <typename ContainerOut, typename Container>
+    ContainerOut sort(std::integral_constant<int, 2>, Container&& xs)
+    {
+        ContainerOut ys = std::forward<Container>(xs);
+        std::vector<std::string*> ptrs;
+        ptrs.reserve(size_of_cont(ys));
+        for (auto& y : ys)
+        {
+            ptrs.push_back(&y);
+        }
+        multikey_quicksort(std::begin(ptrs), std::end(ptrs), 0,
+            [](const std::string* str, std::size_t depth)
+            {
+                return string_digit()(*str, depth);
+            });
+        std::vector<std::string> sorted;
+        sorted.reserve(ptrs.size());
+        for (const auto ptr : ptrs)
+        {
+            sorted.push_back(std::move(*ptr));
+        }
+        std::move(std::begin(sorted), std::end(sorted), std::begin(ys));
+        return ys;
+    }
+
+    template <typename Container>
+    using sort_algorithm_t = std::integral_constant<int,
+        use_radix_sort<Container>::value ? 1 :
+        use_string_sort<Container>::value ? 2 : 0>;
+
+    // Decorate-sort-undecorate:
+    // Every key is calculated only once, and the (key, index) pairs
+    // are sorted, using radix sort for integral keys.
+    // Equal keys keep their original order, so the result is stable.
+    // Floating-point keys are compared instead, because radix sort
+    // would order -0.0 before the equal 0.0.
+    template <typename Key>
+    std::vector<std::size_t> sort_idxs_by_keys(std::false_type,
+        const std::vector<Key>& keys)
+    {
+        std::vector<std::size_t> idxs(keys.size());
+        std::iota(std::begin(idxs), std::end(idxs), std::size_t(0));
+        std::sort(std::begin(idxs), std::end(idxs),
+            [&keys](std::size_t i, std::size_t j)
+            {
+                return keys[i] < keys[j] || (!(keys[j] < keys[i]) && i < j);
+            });
+        return idxs;
+    }
+
+    template <typename Key>
+    std::vector<std::size_t> sort_idxs_by_keys(std::true_type,
+        const std::vector<Key>& keys)
+    {
+        if (keys.size() < radix_sort_min_size)
+            return sort_idxs_by_keys(std::false_type(), keys);
+        typedef typename radix_key<Key>::type RadixKey;
+        std::vector<std::pair<RadixKey, std::size_t>> items;
+        items.reserve(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            items.push_back(std::make_pair(radix_key<Key>::get(keys[i]), i));
+        }
+        radix_sort(items.data(), items.size(),
+            [](const std::pair<RadixKey, std::size_t>& item)
+            {
+                return item.first;
+            });
+        std::vector<std::size_t> idxs;
+        idxs.reserve(items.size());
+        for (const auto& item : items)
+        {
+            idxs.push_back(item.second);
+        }
+        return idxs;
+    }
+
+    template <typename ContainerOut, typename F, typename Container>
+    ContainerOut sort_on(F f, Container&& xs)
+    {
+        typedef typename ContainerOut::value_type T;
+        typedef std::decay_t<detail::invoke_result_t<F, const T&>> Key;
+        std::vector<Key> keys;
+        std::vector<decltype(&*std::begin(xs))> elems;
+        keys.reserve(size_of_cont(xs));
+        elems.reserve(size_of_cont(xs));
+        for (auto& x : xs)
+        {
+            keys.push_back(detail::invoke(f, x));
+            elems.push_back(&x);
+        }
+        const auto idxs = sort_idxs_by_keys(std::integral_constant<bool,
+            is_radix_sortable<Key>::value && std::is_integral<Key>::value>(),
+            keys);
+        ContainerOut ys;
+        internal::prepare_container(ys, size_of_cont(xs));
+        auto it = internal::get_back_inserter<ContainerOut>(ys);
+        for (const auto idx : idxs)
+        {
+            *it = forward_elem(can_reuse_v<Container>{}, *elems[idx]);
+        }
+        return ys;
+    }
+} // namespace internal
+
 // API search type: sort_on : ((a -> b), [a]) -> [a]
 // fwd bind count: 1
 // Sort a sequence by a given transformer.
+// The transformer is called exactly once for every element,
+// and elements with equal keys keep their relative order.
 template <typename F, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut sort_on(F f, Container&& xs)
 {
-    return sort_by(internal::is_less_by_struct<F>(f),
-        std::forward<Container>(xs));
+    FPLUS_INSTRUMENT_CALL("sort_on", Container, xs);
+    return internal::sort_on<ContainerOut>(f, std::forward<Container>(xs));
 }
 
 // API search type: sort : [a] -> [a]
 // fwd bind count: 0
 // Sort a sequence to ascending order using std::less.
+// std::vector and std::array of integers and floating-point numbers
+// are sorted using radix sort,
+// random-access containers of std::string using multikey quicksort.
 template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut sort(Container&& xs)
 {
-    typedef typename std::remove_reference<Container>::type::value_type T;
-    return sort_by(std::less<T>(), std::forward<Container>(xs));
+    FPLUS_INSTRUMENT_CALL("sort", Container, xs);
+    return internal::sort<ContainerOut>(
+        internal::sort_algorithm_t<ContainerOut>(),
+        std::forward<Container>(xs));
 }
 
 namespace internal
@@ -1342,7 +2205,7 @@ template <typename Compare, typename Container>
 Container stable_sort_by(internal::reuse_container_t, Compare comp,
     Container&& xs)
 {
-    std::sort(std::begin(xs), std::end(xs), comp);
+    std::stable_sort(std::begin(xs), std::end(xs), comp);
     return std::forward<Container>(xs);
 }
 
@@ -1351,7 +2214,7 @@ Container stable_sort_by(internal::create_new_container_t, Compare comp,
     const Container& xs)
 {
     auto result = xs;
-    std::sort(std::begin(result), std::end(result), comp);
+    std::stable_sort(std::begin(result), std::end(result), comp);
     return result;
 }
 
@@ -1365,6 +2228,7 @@ template <typename Compare, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut stable_sort_by(Compare comp, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("stable_sort_by", Container, xs);
     return internal::stable_sort_by(internal::can_reuse_v<Container>{},
         comp, std::forward<Container>(xs));
 }
@@ -1372,23 +2236,51 @@ ContainerOut stable_sort_by(Compare comp, Container&& xs)
 // API search type: stable_sort_on : ((a -> b), [a]) -> [a]
 // fwd bind count: 1
 // Sort a sequence stably by given transformer.
+// The transformer is called exactly once for every element.
 template <typename F, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut stable_sort_on(F f, Container&& xs)
 {
-    return stable_sort_by(internal::is_less_by_struct<F>(f),
-        std::forward<Container>(xs));
+    FPLUS_INSTRUMENT_CALL("stable_sort_on", Container, xs);
+    return internal::sort_on<ContainerOut>(f, std::forward<Container>(xs));
 }
 
+namespace internal
+{
+    template <typename ContainerOut, typename Container>
+    ContainerOut stable_sort(std::false_type, Container&& xs)
+    {
+        typedef typename ContainerOut::value_type T;
+        return fplus::stable_sort_by(std::less<T>(),
+            std::forward<Container>(xs));
+    }
+
+    template <typename ContainerOut, typename Container>
+    ContainerOut stable_sort(std::true_type, Container&& xs)
+    {
+        return sort<ContainerOut>(std::integral_constant<int, 1>(),
+            std::forward<Container>(xs));
+    }
+
+    // Equal floating-point values (0.0 and -0.0) can be distinguished,
+    // so radix sort (ordering -0.0 first) would not be stable for them.
+    template <typename Container,
+        typename T = typename Container::value_type>
+    using use_stable_radix_sort = std::integral_constant<bool,
+        use_radix_sort<Container>::value && std::is_integral<T>::value>;
+} // namespace internal
+
 // API search type: stable_sort : [a] -> [a]
 // fwd bind count: 0
 // Sort a sequence stably to ascending order using std::less.
+// std::vector and std::array of integers are sorted using radix sort.
 template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut stable_sort(Container&& xs)
 {
-    typedef typename std::remove_reference<Container>::type::value_type T;
-    return stable_sort_by(std::less<T>(), std::forward<Container>(xs));
+    return internal::stable_sort<ContainerOut>(
+        internal::use_stable_radix_sort<ContainerOut>(),
+        std::forward<Container>(xs));
 }
 
 namespace internal
@@ -1428,6 +2320,7 @@ template <typename Compare, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut partial_sort_by(Compare comp, std::size_t count, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("partial_sort_by", Container, xs);
     return internal::partial_sort_by(internal::can_reuse_v<Container>{},
         comp, count, std::forward<Container>(xs));
 }
@@ -1526,6 +2419,7 @@ template <typename BinaryPredicate, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut unique_by(BinaryPredicate pred, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("unique_by", Container, xs);
     return internal::unique_by(internal::can_reuse_v<Container>{},
         pred, std::forward<Container>(xs));
 }
@@ -1542,6 +2436,7 @@ template <typename F, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut unique_on(F f, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("unique_on", Container, xs);
     return unique_by(internal::is_equal_by_struct<F>(f),
         std::forward<Container>(xs));
 }
@@ -1561,28 +2456,43 @@ ContainerOut unique(Container&& xs)
     return unique_on(identity<T>, std::forward<Container>(xs));
 }
 
+namespace internal
+{
+
+template <typename Reuse, typename X, typename Container,
+    typename ContainerOut = remove_const_and_ref_t<Container>>
+ContainerOut intersperse(Reuse reuse, const X& value, Container&& xs)
+{
+    if (size_of_cont(xs) < 2)
+        return std::forward<Container>(xs);
+    ContainerOut result;
+    internal::prepare_container(result, size_of_cont(xs) * 2 - 1);
+    auto it = internal::get_back_inserter<ContainerOut>(result);
+    bool first = true;
+    for (auto& x : xs)
+    {
+        if (!first)
+            *it = value;
+        *it = internal::forward_elem(reuse, x);
+        first = false;
+    }
+    return result;
+}
+
+} // namespace internal
+
 // API search type: intersperse : (a, [a]) -> [a]
 // fwd bind count: 1
 // Insert a value between all adjacent values in a sequence.
 // intersperse(0, [1, 2, 3]) == [1, 0, 2, 0, 3]
 template <typename Container,
-    typename X = typename Container::value_type>
-Container intersperse(const X& value, const Container& xs)
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>,
+    typename X = typename ContainerOut::value_type>
+ContainerOut intersperse(const X& value, Container&& xs)
 {
-    if (xs.empty())
-        return Container();
-    if (size_of_cont(xs) == 1)
-        return xs;
-    Container result;
-    internal::prepare_container(result, std::max<std::size_t>(0, size_of_cont(xs)*2-1));
-    auto it = internal::get_back_inserter(result);
-    for_each(std::begin(xs), --std::end(xs), [&value, &it](const X& x)
-    {
-        *it = x;
-        *it = value;
-    });
-    *it = xs.back();
-    return result;
+    FPLUS_INSTRUMENT_CALL("intersperse", Container, xs);
+    return internal::intersperse(internal::can_reuse_v<Container>{},
+        value, std::forward<Container>(xs));
 }
 
 // API search type: join : ([a], [[a]]) -> [a]
@@ -1677,6 +2587,7 @@ Container nub_on(F f, const Container& xs)
 template <typename Container>
 Container nub(const Container& xs)
 {
+    FPLUS_INSTRUMENT_CALL("nub", const Container&, xs);
     typedef typename Container::value_type T;
     return nub_by(std::equal_to<T>(), xs);
 }
@@ -1925,6 +2836,46 @@ ContainerOut numbers(const T start, const T end)
     return numbers_step<T, ContainerOut>(start, end, 1);
 }
 
+// API search type: numbers_step_lazy : (a, a, a) -> [a]
+// fwd bind count: 2
+// Lazy version of numbers_step.
+// The numbers are computed on access instead of being stored,
+// element i being start + i * step.
+// Also supports negative steps.
+// numbers_step_lazy(2, 9, 2) == [2, 4, 6, 8]
+// numbers_step_lazy(9, 2, -2) == [9, 7, 5, 3]
+template <typename T>
+auto numbers_step_lazy(const T start, const T end, const T step)
+{
+    std::size_t size = 0;
+    if ((step > 0 && start < end) || (step < 0 && start > end))
+    {
+        size = static_cast<std::size_t>((end - start) / step);
+        const T last = static_cast<T>(start + static_cast<T>(size) * step);
+        if (step > 0 ? last < end : last > end)
+            ++size;
+    }
+    const auto f = [start, step](std::size_t i) -> T
+    {
+        return static_cast<T>(start + static_cast<T>(i) * step);
+    };
+    return view_by_idx<decltype(f)>(f, size);
+}
+
+// API search type: numbers_lazy : (a, a) -> [a]
+// fwd bind count: 1
+// Lazy version of numbers.
+// Iterating does not allocate memory, so large ranges are cheap.
+// The result can be used like a read-only container,
+// e.g. sum(numbers_lazy(0, 1000)) == 499500,
+// and materialized using convert_container.
+// numbers_lazy(2, 9) == [2, 3, 4, 5, 6, 7, 8]
+template <typename T>
+auto numbers_lazy(const T start, const T end)
+{
+    return numbers_step_lazy<T>(start, end, 1);
+}
+
 // API search type: singleton_seq : a -> [a]
 // fwd bind count: 0
 // Construct a sequence containing a single value.
@@ -1994,33 +2945,176 @@ typename Container::value_type last(const Container& xs)
     return xs.back();
 }
 
+namespace internal
+{
+    // Splits the range [it, it + size) into one chunk per hardware thread,
+    // each containing at least min_chunk_size elements,
+    // and applies f(chunk_begin, chunk_end) to every chunk using std::async.
+    // The results are returned in the order of the chunks.
+    template <typename InputIt, typename F>
+    auto transform_chunks_parallelly(std::size_t min_chunk_size,
+        std::size_t size, InputIt it, F f)
+    {
+        typedef std::decay_t<detail::invoke_result_t<F, InputIt, InputIt>>
+            Result;
+        const std::size_t chunk_count = std::max<std::size_t>(1,
+            std::min<std::size_t>(std::thread::hardware_concurrency(),
+                size / std::max<std::size_t>(1, min_chunk_size)));
+        std::vector<std::future<Result>> handles;
+        handles.reserve(chunk_count);
+        for (std::size_t i = 0; i < chunk_count; ++i)
+        {
+            const std::size_t chunk_size = size / chunk_count +
+                (i < size % chunk_count ? 1 : 0);
+            InputIt it_end = it;
+            std::advance(it_end, chunk_size);
+            handles.push_back(std::async(std::launch::async,
+                [f, it, it_end]() { return detail::invoke(f, it, it_end); }));
+            it = it_end;
+        }
+        std::vector<Result> results;
+        results.reserve(chunk_count);
+        for (auto& handle : handles)
+        {
+            results.push_back(handle.get());
+        }
+        return results;
+    }
+} // namespace internal
+
+namespace internal
+{
+    // Running moments of a sequence (Welford),
+    // mergeable with the moments of another sequence (Chan et al.).
+    // m2 is the sum of squared differences from the mean.
+    template <typename Acc>
+    struct moments
+    {
+        std::size_t count;
+        Acc mean;
+        Acc m2;
+
+        void add(Acc x)
+        {
+            ++count;
+            const Acc delta = x - mean;
+            mean += delta / static_cast<Acc>(count);
+            m2 += delta * (x - mean);
+        }
+
+        void merge(const moments<Acc>& other)
+        {
+            if (other.count == 0)
+                return;
+            if (count == 0)
+            {
+                *this = other;
+                return;
+            }
+            const Acc n_a = static_cast<Acc>(count);
+            const Acc n_b = static_cast<Acc>(other.count);
+            const Acc n = n_a + n_b;
+            const Acc delta = other.mean - mean;
+            mean += delta * (n_b / n);
+            m2 += other.m2 + delta * delta * (n_a * n_b / n);
+            count += other.count;
+        }
+    };
+
+    // Integral results would make the running mean useless.
+    template <typename Result>
+    using moments_acc_t = std::conditional_t<
+        std::is_floating_point<Result>::value, Result, double>;
+
+    // Contiguous arithmetic values are processed in independent lanes,
+    // which are merged at the end.
+    template <typename Acc, typename T>
+    moments<Acc> moments_of_range(std::true_type,
+        const T* it, const T* it_end)
+    {
+        const std::size_t size = static_cast<std::size_t>(it_end - it);
+        const std::size_t block_count = size / reduce_lane_count;
+        Acc means[reduce_lane_count] = {};
+        Acc m2s[reduce_lane_count] = {};
+        for (std::size_t i = 0; i < block_count; ++i)
+        {
+            const Acc inv_count = Acc(1) / static_cast<Acc>(i + 1);
+            const T* block = it + i * reduce_lane_count;
+            for (std::size_t j = 0; j < reduce_lane_count; ++j)
+            {
+                const Acc x = static_cast<Acc>(block[j]);
+                const Acc delta = x - means[j];
+                means[j] += delta * inv_count;
+                m2s[j] += delta * (x - means[j]);
+            }
+        }
+        moments<Acc> result = {0, Acc(0), Acc(0)};
+        for (std::size_t j = 0; j < reduce_lane_count; ++j)
+        {
+            result.merge({block_count, means[j], m2s[j]});
+        }
+        for (it += block_count * reduce_lane_count; it != it_end; ++it)
+        {
+            result.add(static_cast<Acc>(*it));
+        }
+        return result;
+    }
+
+    template <typename Acc, typename InputIt>
+    moments<Acc> moments_of_range(std::false_type,
+        InputIt it, InputIt it_end)
+    {
+        moments<Acc> result = {0, Acc(0), Acc(0)};
+        for (; it != it_end; ++it)
+        {
+            result.add(static_cast<Acc>(*it));
+        }
+        return result;
+    }
+
+    template <typename Acc, typename Container>
+    moments<Acc> moments_of(std::true_type, const Container& xs)
+    {
+        return moments_of_range<Acc>(std::true_type(),
+            xs.data(), xs.data() + size_of_cont(xs));
+    }
+
+    template <typename Acc, typename Container>
+    moments<Acc> moments_of(std::false_type, const Container& xs)
+    {
+        return moments_of_range<Acc>(std::false_type(),
+            std::begin(xs), std::end(xs));
+    }
+
+    template <typename Result>
+    std::pair<Result, Result> mean_stddev_from_moments(
+        const moments<moments_acc_t<Result>>& m)
+    {
+        typedef moments_acc_t<Result> Acc;
+        return std::make_pair(static_cast<Result>(m.mean),
+            static_cast<Result>(
+                std::sqrt(m.m2 / static_cast<Acc>(m.count))));
+    }
+} // namespace internal
+
 // API search type: mean_stddev : [a] -> (a, a)
 // fwd bind count: 0
 // Calculates the mean and the population standard deviation.
 // mean_stddev([4, 8]) == (6, 2)
-// mean_stddev([1, 3, 7, 4]) == (3.75, 2.5)
+// mean_stddev([1, 3, 7, 4]) == (3.75, 2.165)
 // xs must be non-empty.
+// Uses a single numerically stable pass (Welford)
+// without allocating memory.
+// For integral Result types, the calculation is done using doubles.
 template <typename Result, typename Container>
 std::pair<Result, Result> mean_stddev(const Container& xs)
 {
+    FPLUS_INSTRUMENT_CALL("mean_stddev", const Container&, xs);
     assert(size_of_cont(xs) != 0);
-
-    // http://stackoverflow.com/a/7616783/1866775
-    Result sum = static_cast<Result>(
-        std::accumulate(xs.begin(), xs.end(),
-            static_cast<typename Container::value_type>(0)));
-    Result mean = sum / static_cast<Result>(xs.size());
-
-    std::vector<Result> diff(xs.size());
-    std::transform(xs.begin(), xs.end(), diff.begin(),
-        [mean](Result x)
-        {
-            return x - mean;
-        });
-    Result sq_sum = std::inner_product(
-        diff.begin(), diff.end(), diff.begin(), static_cast<Result>(0));
-    Result stddev = std::sqrt(sq_sum / static_cast<Result>(xs.size()));
-    return std::make_pair(mean, stddev);
+    typedef internal::moments_acc_t<Result> Acc;
+    return internal::mean_stddev_from_moments<Result>(
+        internal::moments_of<Acc>(
+            internal::is_contiguous_arithmetic<Container>(), xs));
 }
 
 // API search type: count_occurrences_by : ((a -> b), [a]) -> Map b Int
@@ -2045,6 +3139,42 @@ auto count_occurrences_by(F f, const ContainerIn& xs)
     return result;
 }
 
+namespace internal
+{
+
+template <typename MapOut, typename ContainerIn>
+MapOut count_occurrences(std::false_type, const ContainerIn& xs)
+{
+    MapOut result;
+    for (const auto& x : xs)
+    {
+        ++result[x];
+    }
+    return result;
+}
+
+// Sorts the elements once and appends the length of every run.
+template <typename MapOut, typename ContainerIn>
+MapOut count_occurrences(std::true_type, const ContainerIn& xs)
+{
+    typedef typename MapOut::key_type Key;
+    std::vector<Key> keys(std::begin(xs), std::end(xs));
+    const auto comp = MapOut().key_comp();
+    std::sort(std::begin(keys), std::end(keys), comp);
+    MapOut result;
+    auto it = std::begin(keys);
+    while (it != std::end(keys))
+    {
+        const auto run_end = std::upper_bound(it, std::end(keys), *it, comp);
+        result.insert(std::end(result), {*it,
+            static_cast<typename MapOut::mapped_type>(run_end - it)});
+        it = run_end;
+    }
+    return result;
+}
+
+} // namespace internal
+
 // API search type: count_occurrences : [a] -> Map a Int
 // fwd bind count: 0
 // Returns a discrete frequency distribution of the elements in a container
@@ -2057,7 +3187,8 @@ template <typename ContainerIn,
             typename ContainerIn::value_type, std::size_t>>
 MapOut count_occurrences(const ContainerIn& xs)
 {
-    return count_occurrences_by(identity<typename ContainerIn::value_type>, xs);
+    return internal::count_occurrences<MapOut>(
+        internal::is_flat_map<MapOut>{}, xs);
 }
 
 // API search type: lexicographical_less_by : (((a, a) -> Bool), [a], [a]) -> Bool
@@ -2110,15 +3241,60 @@ bool lexicographical_less(const Container& xs, const Container& ys)
         is_less<typename Container::value_type>, xs, ys);
 }
 
+namespace internal
+{
+    template <typename Seq>
+    struct sequence_digit
+    {
+        typedef typename Seq::value_type T;
+        std::pair<bool, T> operator()(const Seq& xs, std::size_t depth) const
+        {
+            return depth < size_of_cont(xs)
+                ? std::make_pair(true, std::begin(xs)[
+                    static_cast<std::ptrdiff_t>(depth)])
+                : std::make_pair(false, T());
+        }
+    };
+
+    template <typename Container,
+        typename Seq = typename Container::value_type>
+    using use_lexicographical_multikey_sort = std::integral_constant<bool,
+        is_random_access_cont<Container>::value &&
+        is_random_access_cont<Seq>::value &&
+        std::is_integral<typename Seq::value_type>::value>;
+
+    template <typename ContainerOut, typename Container>
+    ContainerOut lexicographical_sort(std::false_type, Container&& xs)
+    {
+        typedef typename ContainerOut::value_type T;
+        return fplus::sort_by(lexicographical_less<T>,
+            std::forward<Container>(xs));
+    }
+
+    template <typename ContainerOut, typename Container>
+    ContainerOut lexicographical_sort(std::true_type, Container&& xs)
+    {
+        typedef typename ContainerOut::value_type T;
+        ContainerOut ys = std::forward<Container>(xs);
+        multikey_quicksort(std::begin(ys), std::end(ys), 0,
+            sequence_digit<T>());
+        return ys;
+    }
+} // namespace internal
+
 // API search type: lexicographical_sort : [[a]] -> [[a]]
 // fwd bind count: 0
 // sort by lexicographical_less
+// Random-access containers of random-access sequences of integral values,
+// e.g. std::vector<std::string>, are sorted using multikey quicksort.
 template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut lexicographical_sort(Container&& xs)
 {
-    typedef typename std::remove_reference<Container>::type::value_type T;
-    return sort_by(lexicographical_less<T>, std::forward<Container>(xs));
+    FPLUS_INSTRUMENT_CALL("lexicographical_sort", Container, xs);
+    return internal::lexicographical_sort<ContainerOut>(
+        internal::use_lexicographical_multikey_sort<ContainerOut>(),
+        std::forward<Container>(xs));
 }
 
 // API search type: replicate : (Int, a) -> [a]
@@ -2132,6 +3308,17 @@ ContainerOut replicate(std::size_t n, const T& x)
     return ContainerOut(n, x);
 }
 
+// API search type: replicate_lazy : (Int, a) -> [a]
+// fwd bind count: 1
+// Lazy version of replicate, storing x only once.
+// replicate_lazy(3, 1) == [1, 1, 1]
+template <typename T>
+auto replicate_lazy(std::size_t n, const T& x)
+{
+    const auto f = [x](std::size_t) -> T { return x; };
+    return view_by_idx<decltype(f)>(f, n);
+}
+
 namespace internal
 {
 
@@ -16,10 +16,17 @@
 #include <fplus/sets.hpp>
 
 #include <fplus/detail/invoke.hpp>
+#include <fplus/detail/meta.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <numeric>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace fplus
 {
@@ -132,6 +139,206 @@ maybe<typename std::size_t> maximum_idx_by_maybe(Compare comp,
 }
 
 
+namespace internal
+{
+    // Like sum, the extrema of contiguous arithmetic values
+    // are searched using multiple lanes,
+    // so the compiler can turn the loops into vector min/max instructions.
+    // Each lane starts with the first element and is only updated
+    // on a strict improvement, so a NaN in the sequence is never selected
+    // unless it is the first element, just like with std::min_element.
+    // The lanes are combined preferring the lower index,
+    // so the result is always the first extremum.
+    struct min_better
+    {
+        template <typename T>
+        bool operator()(const T& x, const T& best) const { return x < best; }
+    };
+
+    struct max_better
+    {
+        template <typename T>
+        bool operator()(const T& x, const T& best) const { return best < x; }
+    };
+
+    template <typename T, typename Better>
+    T lane_extremum(const T* xs, std::size_t size, Better better)
+    {
+        assert(size != 0);
+        T values[reduce_lane_count];
+        std::fill(std::begin(values), std::end(values), xs[0]);
+        const std::size_t size_lanes = size - size % reduce_lane_count;
+        std::size_t i = 0;
+        for (; i < size_lanes; i += reduce_lane_count)
+        {
+            for (std::size_t j = 0; j < reduce_lane_count; ++j)
+            {
+                const T x = xs[i + j];
+                values[j] = better(x, values[j]) ? x : values[j];
+            }
+        }
+        for (; i < size; ++i)
+        {
+            values[0] = better(xs[i], values[0]) ? xs[i] : values[0];
+        }
+        T result = values[0];
+        for (std::size_t j = 1; j < reduce_lane_count; ++j)
+        {
+            result = better(values[j], result) ? values[j] : result;
+        }
+        return result;
+    }
+
+    template <typename T, typename Better>
+    struct extremum_idx_lanes
+    {
+        T values[reduce_lane_count];
+        std::size_t idxs[reduce_lane_count];
+
+        explicit extremum_idx_lanes(const T& init)
+        {
+            std::fill(std::begin(values), std::end(values), init);
+            std::fill(std::begin(idxs), std::end(idxs), 0);
+        }
+
+        void update(std::size_t j, const T& x, std::size_t idx)
+        {
+            const bool is_better = Better()(x, values[j]);
+            values[j] = is_better ? x : values[j];
+            idxs[j] = is_better ? idx : idxs[j];
+        }
+
+        std::size_t finish(const T* xs, std::size_t begin, std::size_t end)
+        {
+            const Better better;
+            std::size_t result = 0;
+            for (std::size_t j = 0; j < reduce_lane_count; ++j)
+            {
+                if (better(values[j], values[result]) ||
+                    (!better(values[result], values[j]) &&
+                        idxs[j] < idxs[result]))
+                {
+                    result = j;
+                }
+            }
+            T best = values[result];
+            std::size_t best_idx = idxs[result];
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                if (better(xs[i], best))
+                {
+                    best = xs[i];
+                    best_idx = i;
+                }
+            }
+            return best_idx;
+        }
+    };
+
+    template <typename T, typename Better>
+    std::size_t lane_extremum_idx(const T* xs, std::size_t size, Better)
+    {
+        assert(size != 0);
+        extremum_idx_lanes<T, Better> lanes(xs[0]);
+        const std::size_t size_lanes = size - size % reduce_lane_count;
+        for (std::size_t i = 0; i < size_lanes; i += reduce_lane_count)
+        {
+            for (std::size_t j = 0; j < reduce_lane_count; ++j)
+            {
+                lanes.update(j, xs[i + j], i + j);
+            }
+        }
+        return lanes.finish(xs, size_lanes, size);
+    }
+
+    template <typename T>
+    std::pair<std::size_t, std::size_t> lane_minmax_idx(
+        const T* xs, std::size_t size)
+    {
+        assert(size != 0);
+        extremum_idx_lanes<T, min_better> min_lanes(xs[0]);
+        extremum_idx_lanes<T, max_better> max_lanes(xs[0]);
+        const std::size_t size_lanes = size - size % reduce_lane_count;
+        for (std::size_t i = 0; i < size_lanes; i += reduce_lane_count)
+        {
+            for (std::size_t j = 0; j < reduce_lane_count; ++j)
+            {
+                min_lanes.update(j, xs[i + j], i + j);
+                max_lanes.update(j, xs[i + j], i + j);
+            }
+        }
+        return std::make_pair(
+            min_lanes.finish(xs, size_lanes, size),
+            max_lanes.finish(xs, size_lanes, size));
+    }
+
+    template <typename Container, typename Better>
+    std::size_t extremum_idx(std::true_type, const Container& xs,
+        Better better)
+    {
+        return lane_extremum_idx(xs.data(), size_of_cont(xs), better);
+    }
+
+    template <typename Container, typename Better>
+    std::size_t extremum_idx(std::false_type, const Container& xs,
+        Better better)
+    {
+        typedef typename Container::value_type T;
+        const auto comp = [&](const T& x, const T& y) { return better(x, y); };
+        return minimum_idx_by(comp, xs);
+    }
+
+    template <typename Container, typename Better>
+    typename Container::value_type extremum(std::true_type,
+        const Container& xs, Better better)
+    {
+        return lane_extremum(xs.data(), size_of_cont(xs), better);
+    }
+
+    template <typename Container, typename Better>
+    typename Container::value_type extremum(std::false_type,
+        const Container& xs, Better better)
+    {
+        typedef typename Container::value_type T;
+        const auto comp = [&](const T& x, const T& y) { return better(x, y); };
+        return minimum_by(comp, xs);
+    }
+
+    template <typename Container>
+    std::pair<std::size_t, std::size_t> minmax_idx(std::true_type,
+        const Container& xs)
+    {
+        return lane_minmax_idx(xs.data(), size_of_cont(xs));
+    }
+
+    template <typename Container>
+    std::pair<std::size_t, std::size_t> minmax_idx(std::false_type,
+        const Container& xs)
+    {
+        assert(is_not_empty(xs));
+        auto it = std::begin(xs);
+        auto it_min = it;
+        auto it_max = it;
+        std::size_t idx_min = 0;
+        std::size_t idx_max = 0;
+        std::size_t idx = 1;
+        for (++it; it != std::end(xs); ++it, ++idx)
+        {
+            if (*it < *it_min)
+            {
+                it_min = it;
+                idx_min = idx;
+            }
+            if (*it_max < *it)
+            {
+                it_max = it;
+                idx_max = idx;
+            }
+        }
+        return std::make_pair(idx_min, idx_max);
+    }
+} // namespace internal
+
 // API search type: minimum_idx : [a] -> Int
 // fwd bind count: 0
 // Return the index of the first minimum element.
@@ -140,7 +347,10 @@ maybe<typename std::size_t> maximum_idx_by_maybe(Compare comp,
 template <typename Container>
 typename std::size_t minimum_idx(const Container& xs)
 {
-    return minimum_idx_by(is_less<typename Container::value_type>, xs);
+    assert(is_not_empty(xs));
+    typedef typename Container::value_type T;
+    return internal::extremum_idx(
+        internal::use_lane_kernel<T, Container>(), xs, internal::min_better());
 }
 
 // API search type: minimum_idx_maybe : [a] -> Maybe Int
@@ -165,7 +375,10 @@ maybe<typename std::size_t> minimum_idx_maybe(const Container& xs)
 template <typename Container>
 typename std::size_t maximum_idx(const Container& xs)
 {
-    return maximum_idx_by(is_less<typename Container::value_type>, xs);
+    assert(is_not_empty(xs));
+    typedef typename Container::value_type T;
+    return internal::extremum_idx(
+        internal::use_lane_kernel<T, Container>(), xs, internal::max_better());
 }
 
 // API search type: maximum_idx_maybe : [a] -> Maybe Int
@@ -308,7 +521,10 @@ maybe<typename Container::value_type> maximum_by_maybe(Compare comp,
 template <typename Container>
 typename Container::value_type minimum(const Container& xs)
 {
-    return minimum_by(is_less<typename Container::value_type>, xs);
+    assert(is_not_empty(xs));
+    typedef typename Container::value_type T;
+    return internal::extremum(
+        internal::use_lane_kernel<T, Container>(), xs, internal::min_better());
 }
 
 // API search type: minimum_maybe : [a] -> Maybe a
@@ -334,7 +550,10 @@ maybe<typename Container::value_type> minimum_maybe(const Container& xs)
 template <typename Container>
 typename Container::value_type maximum(const Container& xs)
 {
-    return maximum_by(is_less<typename Container::value_type>, xs);
+    assert(is_not_empty(xs));
+    typedef typename Container::value_type T;
+    return internal::extremum(
+        internal::use_lane_kernel<T, Container>(), xs, internal::max_better());
 }
 
 // API search type: maximum_maybe : [a] -> Maybe a
@@ -353,6 +572,67 @@ maybe<typename Container::value_type> maximum_maybe(const Container& xs)
 }
 
 
+// API search type: minmax : [a] -> (a, a)
+// fwd bind count: 0
+// Return the first minimum and the first maximum element
+// using a single pass over the sequence.
+// minmax([3, 1, 4, 2]) == (1, 4)
+// Unsafe! Crashes on an empty sequence.
+template <typename Container,
+    typename T = typename Container::value_type>
+std::pair<T, T> minmax(const Container& xs)
+{
+    return internal::minmax(internal::use_lane_kernel<T, Container>(), xs);
+}
+
+// API search type: minmax_maybe : [a] -> Maybe (a, a)
+// fwd bind count: 0
+// Return the first minimum and the first maximum element
+// if sequence is not empty.
+// minmax_maybe([3, 1, 4, 2]) == Just (1, 4)
+// minmax_maybe([]) == Nothing
+template <typename Container,
+    typename T = typename Container::value_type>
+maybe<std::pair<T, T>> minmax_maybe(const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minmax(xs);
+}
+
+// API search type: minmax_idx : [a] -> (Int, Int)
+// fwd bind count: 0
+// Return the indices of the first minimum and the first maximum element
+// using a single pass over the sequence.
+// In contrast to std::minmax_element, the first maximum is returned,
+// consistent with minimum_idx and maximum_idx.
+// minmax_idx([3, 1, 4, 2, 4]) == (1, 2)
+// Unsafe! Crashes on an empty sequence.
+template <typename Container>
+std::pair<std::size_t, std::size_t> minmax_idx(const Container& xs)
+{
+    typedef typename Container::value_type T;
+    return internal::minmax_idx(internal::use_lane_kernel<T, Container>(), xs);
+}
+
+// API search type: minmax_idx_maybe : [a] -> Maybe (Int, Int)
+// fwd bind count: 0
+// Return the indices of the first minimum and the first maximum element
+// if sequence is not empty.
+// minmax_idx_maybe([3, 1, 4, 2, 4]) == Just (1, 2)
+// minmax_idx_maybe([]) == Nothing
+template <typename Container>
+maybe<std::pair<std::size_t, std::size_t>> minmax_idx_maybe(
+    const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minmax_idx(xs);
+}
+
+
 // API search type: minimum_on : ((a -> b), [a]) -> a
 // fwd bind count: 1
 // Return the first minimum element using a transformer.
@@ -452,58 +732,396 @@ T mean_obj_div_double(const Container& xs)
     return sum(xs) / static_cast<double>(size_of_cont(xs));
 }
 
+namespace internal
+{
+    template <typename T>
+    struct sum_as_double_lane_op
+    {
+        const T* xs;
+        void operator()(double& acc, std::size_t idx) const
+        {
+            acc += static_cast<double>(xs[idx]);
+        }
+        double combine(double a, double b) const { return a + b; }
+    };
+
+    template <typename Container>
+    double sum_as_doubles(std::true_type, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return reduce_lanes<double>(size_of_cont(xs), 0.0, 0.0,
+            sum_as_double_lane_op<T>{xs.data()});
+    }
+
+    template <typename Container>
+    double sum_as_doubles(std::false_type, const Container& xs)
+    {
+        double result = 0.0;
+        for (const auto& x : xs)
+        {
+            result += static_cast<double>(x);
+        }
+        return result;
+    }
+} // namespace internal
+
 // API search type: mean_using_doubles : [a] -> a
 // fwd bind count: 0
 // mean_using_doubles([1, 4, 4]) == 3
 // Converts elements to double before calculating the sum
 // to prevent overflows.
+// No temporary container is allocated for the converted values.
 // Unsafe! Crashes on an empty sequence.
 template <typename Result, typename Container>
 Result mean_using_doubles(const Container& xs)
 {
     auto size = size_of_cont(xs);
     assert(size != 0);
-    auto xs_as_doubles = convert_elems<double>(xs);
-    auto result_as_double = mean<double>(xs_as_doubles);
+    const double result_as_double =
+        internal::sum_as_doubles(
+            internal::is_contiguous_arithmetic<Container>(), xs) /
+        static_cast<double>(size);
     if (!std::is_integral<Result>::value)
         return static_cast<Result>(result_as_double);
     else
         return round<double, Result>(result_as_double);
 }
 
+namespace internal
+{
+    // Random-access containers are partially sorted in a copy of themselves,
+    // all others in a copy as std::vector.
+    template <typename Container>
+    using selection_buffer_t = std::conditional_t<
+        is_random_access_cont<Container>::value,
+        Container,
+        std::vector<typename Container::value_type>>;
+
+    template <typename Container>
+    remove_const_and_ref_t<Container> make_selection_buffer(
+        std::true_type, Container&& xs)
+    {
+        return std::forward<Container>(xs);
+    }
+
+    template <typename Container>
+    std::vector<typename Container::value_type> make_selection_buffer(
+        std::false_type, const Container& xs)
+    {
+        return convert_container<
+            std::vector<typename Container::value_type>>(xs);
+    }
+
+    template <typename Container>
+    selection_buffer_t<remove_const_and_ref_t<Container>>
+    make_selection_buffer(Container&& xs)
+    {
+        return make_selection_buffer(
+            is_random_access_cont<remove_const_and_ref_t<Container>>(),
+            std::forward<Container>(xs));
+    }
+
+    // Rearranges [first, last) such that for every index in idxs
+    // (sorted, unique, relative to first + offset)
+    // the element is the one a full sort would put there.
+    // O(n * log(k)) for k indices.
+    template <typename RandomIt, typename IdxIt>
+    void multi_select(RandomIt first, RandomIt last,
+        IdxIt idxs_begin, IdxIt idxs_end, std::size_t offset)
+    {
+        while (idxs_begin != idxs_end)
+        {
+            const IdxIt idx_mid = idxs_begin + (idxs_end - idxs_begin) / 2;
+            const auto nth = first +
+                static_cast<std::ptrdiff_t>(*idx_mid - offset);
+            std::nth_element(first, nth, last);
+            multi_select(first, nth, idxs_begin, idx_mid, offset);
+            first = nth + 1;
+            offset = *idx_mid + 1;
+            idxs_begin = idx_mid + 1;
+        }
+    }
+
+    template <typename Result, typename RandomIt>
+    Result median_of_range(RandomIt first, RandomIt last)
+    {
+        const auto size = static_cast<std::size_t>(std::distance(first, last));
+        assert(size != 0);
+        const auto mid = first + static_cast<std::ptrdiff_t>(size / 2);
+        std::nth_element(first, mid, last);
+        if (size % 2 == 1)
+        {
+            return static_cast<Result>(*mid);
+        }
+        else
+        {
+            const auto it1 = std::max_element(first, mid);
+            return static_cast<Result>(*it1 + *mid) / static_cast<Result>(2);
+        }
+    }
+} // namespace internal
+
 // API search type: median : [a] -> a
 // fwd bind count: 0
 // median([5, 6, 4, 3, 2, 6, 7, 9, 3]) == 5
+// Uses selection (std::nth_element) on a copy of the sequence, i.e., O(n).
 // Unsafe! Crashes on an empty sequence.
 template <typename Container,
         typename Result = typename Container::value_type>
 Result median(const Container& xs)
 {
+    FPLUS_INSTRUMENT_CALL("median", const Container&, xs);
     assert(is_not_empty(xs));
 
     if (size_of_cont(xs) == 1)
         return static_cast<Result>(xs.front());
 
-    // std::nth_element (instead of sorting)
-    // would be faster for random-access containers
-    // but not work at all on other containers like std::list.
-    auto xsSorted = sort(xs);
-    if (size_of_cont(xsSorted) % 2 == 1)
+    auto ys = internal::make_selection_buffer(xs);
+    return internal::median_of_range<Result>(std::begin(ys), std::end(ys));
+}
+
+// API search type: quantiles : ([Float], [a]) -> [a]
+// fwd bind count: 1
+// Calculates the quantiles for the given probabilities
+// by linear interpolation between the two closest ranks,
+// like the default method of R and numpy.
+// quantiles([0, 0.25, 0.5, 1], [5, 1, 4, 2, 3]) == [1, 2, 3, 5]
+// quantiles([0.5], [1.0, 2.0, 3.0, 4.0]) == [2.5]
+// All quantiles are found in one multi-selection pass
+// over a copy of the sequence, i.e., O(n * log(len(ps))).
+// Probabilities outside of [0, 1] are clamped, NaN is treated like 0.
+// Interpolated values are truncated if Result is an integral type,
+// e.g. quantiles([0.5], [1, 2, 3, 4]) == [2].
+// Unsafe! Crashes on an empty sequence.
+template <typename ContainerPs, typename Container,
+        typename Result = typename Container::value_type>
+std::vector<Result> quantiles(const ContainerPs& ps, const Container& xs)
+{
+    assert(is_not_empty(xs));
+    const std::size_t size = size_of_cont(xs);
+    const auto rank_of = [size](double p) -> double
     {
-        auto it = std::begin(xsSorted);
-        internal::advance_iterator(it, size_of_cont(xsSorted) / 2);
-        return static_cast<Result>(*it);
+        // Written such that NaN fails the comparison.
+        if (!(p > 0.0))
+            return 0.0;
+        return std::min(p, 1.0) * static_cast<double>(size - 1);
+    };
+    std::vector<std::size_t> idxs;
+    idxs.reserve(2 * size_of_cont(ps));
+    for (const auto& p : ps)
+    {
+        const double rank = rank_of(static_cast<double>(p));
+        const auto idx = static_cast<std::size_t>(rank);
+        idxs.push_back(idx);
+        if (static_cast<double>(idx) != rank)
+            idxs.push_back(idx + 1);
     }
-    else
+    std::sort(std::begin(idxs), std::end(idxs));
+    idxs.erase(std::unique(std::begin(idxs), std::end(idxs)), std::end(idxs));
+
+    auto ys = internal::make_selection_buffer(xs);
+    internal::multi_select(std::begin(ys), std::end(ys),
+        std::begin(idxs), std::end(idxs), 0);
+
+    std::vector<Result> result;
+    result.reserve(size_of_cont(ps));
+    for (const auto& p : ps)
     {
-        auto it1 = std::begin(xsSorted);
-        internal::advance_iterator(it1, size_of_cont(xsSorted) / 2 - 1);
-        auto it2 = it1;
-        ++it2;
-        return static_cast<Result>(*it1 + *it2) / static_cast<Result>(2);
+        const double rank = rank_of(static_cast<double>(p));
+        const auto idx = static_cast<std::size_t>(rank);
+        const double frac = rank - static_cast<double>(idx);
+        const auto& lower = ys[idx];
+        if (frac == 0.0)
+        {
+            result.push_back(static_cast<Result>(lower));
+        }
+        else
+        {
+            const auto& upper = ys[idx + 1];
+            result.push_back(static_cast<Result>(
+                static_cast<double>(lower) + frac *
+                    (static_cast<double>(upper) - static_cast<double>(lower))));
+        }
     }
+    return result;
 }
 
+// A streaming sketch of approximate quantiles (KLL)
+// using memory logarithmic in the number of added values.
+// Values are collected in levels of compactors.
+// Every full compactor is sorted and every other value
+// is promoted to the next level, where it counts twice as much.
+// Whether the odd or the even values are promoted is decided randomly
+// (with a fixed seed), which keeps the estimates unbiased.
+// The rank error is roughly proportional to 1 / k,
+// so a larger k gives more accurate results using more memory.
+// Sketches of parts of a sequence can be merged.
+// quantile_sketch<double> sketch;
+// for (double x : latencies) sketch.add(x);
+// sketch.quantile(0.99) == approximately the 99th percentile
+template <typename T>
+class quantile_sketch
+{
+public:
+    explicit quantile_sketch(std::size_t k = 256) :
+        k_(std::max<std::size_t>(k, 2)),
+        count_(0),
+        levels_(),
+        min_(),
+        max_(),
+        random_state_(2463534242)
+    {
+    }
+
+    void add(const T& x)
+    {
+        if (count_ == 0 || x < min_)
+            min_ = x;
+        if (count_ == 0 || max_ < x)
+            max_ = x;
+        ++count_;
+        if (levels_.empty())
+            levels_.emplace_back();
+        levels_.front().push_back(x);
+        if (levels_.front().size() >= capacity(0))
+            compact();
+    }
+
+    void merge(const quantile_sketch<T>& other)
+    {
+        if (other.count_ == 0)
+            return;
+        if (count_ == 0 || other.min_ < min_)
+            min_ = other.min_;
+        if (count_ == 0 || max_ < other.max_)
+            max_ = other.max_;
+        count_ += other.count_;
+        if (levels_.size() < other.levels_.size())
+            levels_.resize(other.levels_.size());
+        for (std::size_t level = 0; level < other.levels_.size(); ++level)
+        {
+            levels_[level].insert(std::end(levels_[level]),
+                std::begin(other.levels_[level]),
+                std::end(other.levels_[level]));
+        }
+        compact();
+    }
+
+    // Number of values added so far.
+    std::size_t size() const
+    {
+        return count_;
+    }
+
+    // Returns the value at approximately rank p * (size() - 1).
+    // Unsafe! Crashes on an empty sketch.
+    T quantile(double p) const
+    {
+        return quantiles(std::vector<double>({p})).front();
+    }
+
+    // Unsafe! Crashes on an empty sketch.
+    template <typename ContainerPs>
+    std::vector<T> quantiles(const ContainerPs& ps) const
+    {
+        assert(count_ != 0);
+        std::vector<std::pair<T, std::uint64_t>> weighted;
+        std::uint64_t weight = 1;
+        for (const auto& level : levels_)
+        {
+            for (const auto& x : level)
+            {
+                weighted.push_back(std::make_pair(x, weight));
+            }
+            weight *= 2;
+        }
+        std::sort(std::begin(weighted), std::end(weighted),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<T> result;
+        result.reserve(size_of_cont(ps));
+        for (const auto& p_raw : ps)
+        {
+            const double p = static_cast<double>(p_raw);
+            if (!(p > 0.0))
+            {
+                result.push_back(min_);
+                continue;
+            }
+            if (p >= 1.0)
+            {
+                result.push_back(max_);
+                continue;
+            }
+            const double rank = p * static_cast<double>(count_ - 1);
+            std::uint64_t cumulative_weight = 0;
+            auto it = std::begin(weighted);
+            for (; it != std::end(weighted); ++it)
+            {
+                cumulative_weight += it->second;
+                if (static_cast<double>(cumulative_weight) > rank)
+                    break;
+            }
+            result.push_back(it == std::end(weighted)
+                ? max_ : it->first);
+        }
+        return result;
+    }
+
+private:
+    // Lower levels hold fewer values, since their values weigh less.
+    std::size_t capacity(std::size_t level) const
+    {
+        const std::size_t depth = levels_.size() - level - 1;
+        double capacity = static_cast<double>(k_);
+        for (std::size_t i = 0; i < depth && capacity > 2.0; ++i)
+            capacity *= 2.0 / 3.0;
+        return std::max<std::size_t>(2,
+            static_cast<std::size_t>(std::ceil(capacity)));
+    }
+
+    // xorshift32
+    std::size_t random_bit()
+    {
+        random_state_ ^= random_state_ << 13;
+        random_state_ ^= random_state_ >> 17;
+        random_state_ ^= random_state_ << 5;
+        return random_state_ >> 31;
+    }
+
+    void compact()
+    {
+        for (std::size_t level = 0; level < levels_.size(); ++level)
+        {
+            if (levels_[level].size() < capacity(level))
+                continue;
+            if (level + 1 == levels_.size())
+                levels_.emplace_back();
+            auto& values = levels_[level];
+            std::sort(std::begin(values), std::end(values));
+            // An odd value stays on this level.
+            const bool keep_last = values.size() % 2 == 1;
+            const std::size_t offset = random_bit();
+            auto& next_level = levels_[level + 1];
+            for (std::size_t i = offset;
+                i + (keep_last ? 1 : 0) < values.size(); i += 2)
+            {
+                next_level.push_back(values[i]);
+            }
+            if (keep_last)
+                values.erase(std::begin(values), std::end(values) - 1);
+            else
+                values.clear();
+        }
+    }
+
+    std::size_t k_;
+    std::size_t count_;
+    std::vector<std::vector<T>> levels_;
+    T min_;
+    T max_;
+    std::uint32_t random_state_;
+};
+
 // API search type: all_unique_by_less : (((a, a) -> Bool), [a]) -> Bool
 // fwd bind count: 1
 // Returns true for empty containers.
@@ -544,22 +1162,14 @@ bool is_infix_of(const Container& token, const Container& xs)
 template <typename Container>
 bool is_subsequence_of(const Container& seq, const Container& xs)
 {
-    if (is_empty(seq))
-        return true;
-    if (size_of_cont(seq) > size_of_cont(xs))
-        return false;
-    typedef typename Container::value_type T;
-    auto remaining = convert_container_and_elems<std::list<T>>(seq);
-    for (const auto& x : xs)
+    auto it_seq = std::begin(seq);
+    for (auto it = std::begin(xs);
+        it != std::end(xs) && it_seq != std::end(seq); ++it)
     {
-        if (x == remaining.front())
-        {
-            remaining.pop_front();
-            if (is_empty(remaining))
-                return true;
-        }
+        if (*it == *it_seq)
+            ++it_seq;
     }
-    return false;
+    return it_seq == std::end(seq);
 }
 
 // API search type: count_if : ((a -> Bool), [a]) -> Int
@@ -616,16 +1226,57 @@ bool is_unique_in
     return is_unique_in_by(is_equal_to(x), xs);
 }
 
+namespace internal
+{
+
+template <typename T, typename = void>
+struct is_hashable : std::false_type {};
+template <typename T>
+struct is_hashable<T, detail::void_t<decltype(
+    std::hash<T>()(std::declval<const T&>()))>> : std::true_type {};
+
+template <typename Container>
+bool is_permutation_of(std::false_type,
+    const Container& xs, const Container& ys)
+{
+    return fplus::sort(xs) == fplus::sort(ys);
+}
+
+// Counts the elements of xs and uncounts the ones of ys,
+// stopping at the first element of ys that is left over.
+// Both have the same size, so nothing of xs can be left over then.
+template <typename Container>
+bool is_permutation_of(std::true_type,
+    const Container& xs, const Container& ys)
+{
+    typedef typename Container::value_type T;
+    std::unordered_map<T, std::size_t> counts;
+    counts.reserve(size_of_cont(xs));
+    for (const auto& x : xs)
+        ++counts[x];
+    for (const auto& y : ys)
+    {
+        const auto it = counts.find(y);
+        if (it == std::end(counts) || it->second == 0)
+            return false;
+        --it->second;
+    }
+    return true;
+}
+
+} // namespace internal
+
 // API search type: is_permutation_of : ([a], [a]) -> Bool
 // fwd bind count: 1
 // Checks if one container is a permuation of the other one.
 // is_permutation_of([2,3,1], [1,2,3]) == true
-// O(log(n))
+// O(n) for hashable elements, O(n*log(n)) otherwise.
 template <typename Container>
 bool is_permutation_of(const Container& xs, const Container& ys)
 {
+    typedef typename Container::value_type T;
     return size_of_cont(xs) == size_of_cont(ys) &&
-        sort(xs) == sort(ys);
+        internal::is_permutation_of(internal::is_hashable<T>(), xs, ys);
 }
 
 // API search type: fill_pigeonholes_to : (Int, [Int]) -> [Int]
@@ -645,19 +1296,14 @@ ContainerOut fill_pigeonholes_to(std::size_t idx_end, const ContainerIn& xs)
     if (is_empty(xs))
         return {};
 
-    ContainerOut result(idx_end, 0);
-    for (const auto& x : xs)
-    {
-        if (x >= 0)
+    return internal::bin_counts<ContainerOut>(idx_end, xs,
+        [idx_end](const T& x) -> internal::bin_idx_range
         {
             const auto idx = static_cast<std::size_t>(x);
-            if (idx < result.size())
-            {
-                ++result[idx];
-            }
-        }
-    }
-    return result;
+            return x >= 0 && idx < idx_end
+                ? internal::bin_idx_range(idx, idx + 1)
+                : internal::bin_idx_range(0, 0);
+        });
 }
 
 // API search type: fill_pigeonholes : [Int] -> [Int]
@@ -737,17 +1383,23 @@ ContainerOut fill_pigeonholes_bool(const ContainerIn& xs)
 // Returns a list containing only the elements present in all sublists of xs.
 // Also known as gemstones.
 // present_in_all([[4,1,2], [5,2,1], [2,4,1]]) == [1,2]
+// The sublists are converted into sorted vectors and intersected
+// via sets_intersection.
 template <typename ContainerIn,
     typename SubContainerIn = typename ContainerIn::value_type,
     typename T = typename SubContainerIn::value_type,
     typename ContainerOut = std::vector<T>>
 ContainerOut present_in_all(const ContainerIn& xs)
 {
+    typedef std::vector<T> SortedVec;
+    const auto to_sorted_set = [](const SubContainerIn& ys) -> SortedVec
+    {
+        return fplus::unique(fplus::sort(
+            convert_container<SortedVec>(ys)));
+    };
     return convert_container<ContainerOut>(
         fplus::sets_intersection(
-            transform(
-                convert_container<std::set<T>, SubContainerIn>,
-                xs)));
+            transform_convert<std::vector<SortedVec>>(to_sorted_set, xs)));
 }
 
 } // namespace fplus
@@ -150,6 +150,18 @@ struct remove_const_and_ref
 template<typename T>
 using remove_const_and_ref_t = typename remove_const_and_ref<T>::type;
 
+// Type of container holding the elements of Container,
+// differs from Container only for read-only views.
+template <typename Container>
+struct materialized
+{
+    typedef Container type;
+};
+
+template <typename Container>
+using materialized_t =
+    typename materialized<remove_const_and_ref_t<Container>>::type;
+
 
 } // namespace internal
 
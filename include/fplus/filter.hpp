@@ -18,8 +18,8 @@ namespace fplus
 namespace internal
 {
 
-template <typename Pred, typename Container>
-Container keep_if(internal::reuse_container_t, Pred pred, Container&& xs)
+template <typename ContainerOut, typename Pred, typename Container>
+ContainerOut keep_if(internal::reuse_container_t, Pred pred, Container&& xs)
 {
     internal::check_unary_predicate_for_container<Pred, Container>();
     xs.erase(std::remove_if(
@@ -27,13 +27,13 @@ Container keep_if(internal::reuse_container_t, Pred pred, Container&& xs)
     return std::forward<Container>(xs);
 }
 
-template <typename Pred, typename Container>
-Container keep_if(internal::create_new_container_t, Pred pred,
+template <typename ContainerOut, typename Pred, typename Container>
+ContainerOut keep_if(internal::create_new_container_t, Pred pred,
     const Container& xs)
 {
     internal::check_unary_predicate_for_container<Pred, Container>();
-    Container result;
-    auto it = internal::get_back_inserter<Container>(result);
+    ContainerOut result;
+    auto it = internal::get_back_inserter<ContainerOut>(result);
     std::copy_if(std::begin(xs), std::end(xs), it, pred);
     return result;
 }
@@ -46,10 +46,11 @@ Container keep_if(internal::create_new_container_t, Pred pred,
 // keep_if(is_even, [1, 2, 3, 2, 4, 5]) == [2, 2, 4]
 // Also known as filter.
 template <typename Pred, typename Container,
-    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+    typename ContainerOut = internal::materialized_t<Container>>
 ContainerOut keep_if(Pred pred, Container&& xs)
 {
-    return internal::keep_if(internal::can_reuse_v<Container>{},
+    FPLUS_INSTRUMENT_CALL("keep_if", Container, xs);
+    return internal::keep_if<ContainerOut>(internal::can_reuse_v<Container>{},
         pred, std::forward<Container>(xs));
 }
 
@@ -59,9 +60,10 @@ ContainerOut keep_if(Pred pred, Container&& xs)
 // drop_if(is_even, [1, 2, 3, 2, 4, 5]) == [1, 3, 5]
 // Also known as reject.
 template <typename Pred, typename Container,
-    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+    typename ContainerOut = internal::materialized_t<Container>>
 ContainerOut drop_if(Pred pred, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("drop_if", Container, xs);
     return keep_if(logical_not(pred), std::forward<Container>(xs));
 }
 
@@ -166,6 +168,7 @@ template <typename UnaryPredicate, typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut keep_by_idx(UnaryPredicate pred, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("keep_by_idx", Container, xs);
     internal::check_unary_predicate_for_type<UnaryPredicate, std::size_t>();
     return internal::keep_by_idx(internal::can_reuse_v<Container>{},
         pred, std::forward<Container>(xs));
@@ -183,70 +186,146 @@ ContainerOut drop_by_idx(UnaryPredicate pred, Container&& xs)
     return keep_by_idx(logical_not(pred), std::forward<Container>(xs));
 }
 
-// API search type: keep_idxs : ([Int], [a]) -> [a]
-// fwd bind count: 1
-// Keep the elements of a sequence with an index present in idxs_to_keep.
-// keep_idxs([2,5], [1,2,3,4,5,6,7]) == [3,6]
-template <typename ContainerIdxs, typename Container>
-Container keep_idxs(const ContainerIdxs& idxs_to_keep, const Container& xs)
+namespace internal
 {
-    static_assert(std::is_same<typename ContainerIdxs::value_type, std::size_t>::value,
-        "Indices must be std::size_t");
-    auto idxs_left = convert_container<std::list<std::size_t>>(
-        unique(sort(idxs_to_keep)));
+
+template <typename ContainerIdxs>
+std::vector<std::size_t> sorted_unique_idxs(const ContainerIdxs& idxs)
+{
+    auto result = convert_container<std::vector<std::size_t>>(idxs);
+    if (!std::is_sorted(std::begin(result), std::end(result)))
+        std::sort(std::begin(result), std::end(result));
+    result.erase(std::unique(std::begin(result), std::end(result)),
+        std::end(result));
+    return result;
+}
+
+template <typename Container>
+Container keep_idxs(std::true_type,
+    const std::vector<std::size_t>& idxs, const Container& xs)
+{
+    const std::size_t xs_size = size_of_cont(xs);
     Container ys;
+    internal::prepare_container(ys, idxs.size());
     auto it = internal::get_back_inserter<Container>(ys);
+    for (std::size_t idx : idxs)
+    {
+        if (idx >= xs_size)
+            break;
+        *it = *internal::add_to_iterator(std::begin(xs), idx);
+    }
+    return ys;
+}
+
+template <typename Container>
+Container keep_idxs(std::false_type,
+    const std::vector<std::size_t>& idxs, const Container& xs)
+{
+    Container ys;
+    auto it = internal::get_back_inserter<Container>(ys);
+    auto idxs_it = std::begin(idxs);
     std::size_t idx = 0;
     for (const auto& x : xs)
     {
-        if (!idxs_left.empty() && idxs_left.front() == idx)
+        if (idxs_it == std::end(idxs))
+            break;
+        if (*idxs_it == idx)
         {
-            idxs_left.pop_front();
             *it = x;
+            ++idxs_it;
         }
         ++idx;
     }
     return ys;
 }
 
-// API search type: drop_idxs : ([Int], [a]) -> [a]
+} // namespace internal
+
+// API search type: keep_idxs : ([Int], [a]) -> [a]
 // fwd bind count: 1
-// Drop the elements of a sequence with an index present in idxs_to_keep.
-// drop_idxs([2,5], [1,2,3,4,5,6,7]) == [1,2,4,5,7]
+// Keep the elements of a sequence with an index present in idxs_to_keep.
+// keep_idxs([2,5], [1,2,3,4,5,6,7]) == [3,6]
 template <typename ContainerIdxs, typename Container>
-Container drop_idxs(const ContainerIdxs& idxs_to_drop, const Container& xs)
+Container keep_idxs(const ContainerIdxs& idxs_to_keep, const Container& xs)
 {
+    FPLUS_INSTRUMENT_CALL("keep_idxs", const Container&, xs);
     static_assert(std::is_same<typename ContainerIdxs::value_type, std::size_t>::value,
         "Indices must be std::size_t");
-    auto idxs_left = convert_container<std::list<std::size_t>>(
-        unique(sort(idxs_to_drop)));
+    return internal::keep_idxs(internal::is_random_access_cont<Container>{},
+        internal::sorted_unique_idxs(idxs_to_keep), xs);
+}
+
+namespace internal
+{
+
+template <typename ContainerIdxs, typename Container>
+Container drop_idxs(internal::reuse_container_t,
+    const ContainerIdxs& idxs_to_drop, Container&& xs)
+{
+    const auto idxs = sorted_unique_idxs(idxs_to_drop);
+    auto idxs_it = std::begin(idxs);
+    const auto is_kept = [&idxs_it, &idxs](std::size_t idx) -> bool
+    {
+        if (idxs_it == std::end(idxs) || *idxs_it != idx)
+            return true;
+        ++idxs_it;
+        return false;
+    };
+    return internal::keep_by_idx(internal::reuse_container_t(),
+        is_kept, std::forward<Container>(xs));
+}
+
+template <typename ContainerIdxs, typename Container>
+Container drop_idxs(internal::create_new_container_t,
+    const ContainerIdxs& idxs_to_drop, const Container& xs)
+{
+    const auto idxs = sorted_unique_idxs(idxs_to_drop);
+    const std::size_t xs_size = size_of_cont(xs);
+    const auto idxs_in_range = static_cast<std::size_t>(std::distance(
+        std::begin(idxs),
+        std::lower_bound(std::begin(idxs), std::end(idxs), xs_size)));
     Container ys;
+    internal::prepare_container(ys, xs_size - idxs_in_range);
     auto it = internal::get_back_inserter<Container>(ys);
+    auto idxs_it = std::begin(idxs);
     std::size_t idx = 0;
     for (const auto& x : xs)
     {
-        if (idxs_left.empty() || idxs_left.front() != idx)
-        {
-            *it = x;
-        }
+        if (idxs_it != std::end(idxs) && *idxs_it == idx)
+            ++idxs_it;
         else
-        {
-            if (!idxs_left.empty())
-                idxs_left.pop_front();
-        }
+            *it = x;
         ++idx;
     }
     return ys;
 }
 
+} // namespace internal
+
+// API search type: drop_idxs : ([Int], [a]) -> [a]
+// fwd bind count: 1
+// Drop the elements of a sequence with an index present in idxs_to_keep.
+// drop_idxs([2,5], [1,2,3,4,5,6,7]) == [1,2,4,5,7]
+template <typename ContainerIdxs, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut drop_idxs(const ContainerIdxs& idxs_to_drop, Container&& xs)
+{
+    FPLUS_INSTRUMENT_CALL("drop_idxs", Container, xs);
+    static_assert(std::is_same<typename ContainerIdxs::value_type, std::size_t>::value,
+        "Indices must be std::size_t");
+    return internal::drop_idxs(internal::can_reuse_v<Container>{},
+        idxs_to_drop, std::forward<Container>(xs));
+}
+
 // API search type: drop_idx : (Int, [a]) -> [a]
 // fwd bind count: 1
 // Remove the element at a specific index from a sequence.
 // drop_idx(2, [1,2,3,4,5,6,7]) == [1,2,4,5,6,7]
-template <typename Container>
-Container drop_idx(std::size_t idx, const Container& xs)
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut drop_idx(std::size_t idx, Container&& xs)
 {
-    return drop_by_idx(is_equal_to(idx), xs);
+    return drop_by_idx(is_equal_to(idx), std::forward<Container>(xs));
 }
 
 // API search type: justs : [Maybe a] -> [a]
@@ -317,10 +396,11 @@ ContainerOut errors(const ContainerIn& xs)
 // trim_left('_', "___abc__") == "abc__"
 // trim_left(0, [0,0,0,5,6,7,8,6,4]) == [5,6,7,8,6,4]
 template <typename Container,
-        typename T = typename Container::value_type>
-Container trim_left(const T& x, const Container& xs)
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>,
+    typename T = typename ContainerOut::value_type>
+ContainerOut trim_left(const T& x, Container&& xs)
 {
-    return drop_while(is_equal_to(x), xs);
+    return drop_while(is_equal_to(x), std::forward<Container>(xs));
 }
 
 // API search type: trim_token_left : ([a], [a]) -> [a]
@@ -342,11 +422,17 @@ Container trim_token_left(const Container& token, const Container& xs)
 // fwd bind count: 1
 // Remove elements from the left as long as p is fulfilled.
 // trim_right_by(is_even, [0,2,4,5,6,7,8,6,4]) == [0,2,4,5,6,7]
-template <typename Container, typename UnaryPredicate>
-Container trim_right_by(UnaryPredicate p, const Container& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    return reverse(drop_while(p, reverse(xs)));
+template <typename Container, typename UnaryPredicate,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut trim_right_by(UnaryPredicate p, Container&& xs)
+{
+    internal::check_unary_predicate_for_container<
+        UnaryPredicate, ContainerOut>();
+    const auto it_last = std::find_if_not(
+        xs.rbegin(), xs.rend(), p).base();
+    return take(static_cast<std::size_t>(
+            std::distance(std::begin(xs), it_last)),
+        std::forward<Container>(xs));
 }
 
 // API search type: trim_right : (a, [a]) -> [a]
@@ -355,10 +441,11 @@ Container trim_right_by(UnaryPredicate p, const Container& xs)
 // trim_right('_', "___abc__") == "___abc"
 // trim_right(4, [0,2,4,5,6,7,8,4,4]) == [0,2,4,5,6,7,8]
 template <typename Container,
-        typename T = typename Container::value_type>
-Container trim_right(const T& x, const Container& xs)
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>,
+    typename T = typename ContainerOut::value_type>
+ContainerOut trim_right(const T& x, Container&& xs)
 {
-    return trim_right_by(is_equal_to(x), xs);
+    return trim_right_by(is_equal_to(x), std::forward<Container>(xs));
 }
 
 // API search type: trim_token_right : ([a], [a]) -> [a]
@@ -375,11 +462,13 @@ Container trim_token_right(const Container& token, const Container& xs)
 // fwd bind count: 1
 // Remove elements from the left and right as long as p is fulfilled.
 // trim_by(is_even, [0,2,4,5,6,7,8,6,4]) == [5,6,7]
-template <typename Container, typename UnaryPredicate>
-Container trim_by(UnaryPredicate p, const Container& xs)
+template <typename Container, typename UnaryPredicate,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut trim_by(UnaryPredicate p, Container&& xs)
 {
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    return trim_right_by(p, drop_while(p, xs));
+    internal::check_unary_predicate_for_container<
+        UnaryPredicate, ContainerOut>();
+    return trim_right_by(p, drop_while(p, std::forward<Container>(xs)));
 }
 
 // API search type: trim : (a, [a]) -> [a]
@@ -388,10 +477,11 @@ Container trim_by(UnaryPredicate p, const Container& xs)
 // trim('_', "___abc__") == "abc"
 // trim(0, [0,2,4,5,6,7,8,0,0]) == [2,4,5,6,7,8]
 template <typename Container,
-        typename T = typename Container::value_type>
-Container trim(const T& x, const Container& xs)
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>,
+    typename T = typename ContainerOut::value_type>
+ContainerOut trim(const T& x, Container&& xs)
 {
-    return trim_right(x, trim_left(x, xs));
+    return trim_right(x, trim_left(x, std::forward<Container>(xs)));
 }
 
 // API search type: trim_token : ([a], [a]) -> [a]
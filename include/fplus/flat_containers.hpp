@@ -0,0 +1,341 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <fplus/container_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Map stored as an std::vector of (key, value) pairs sorted by key.
+// Lookups are binary searches in contiguous memory,
+// iterating is a linear scan.
+// Inserting a new key in the middle is O(n),
+// appending keys in ascending order is O(1) amortized.
+// So it is meant for maps that are built once and read often,
+// e.g. by pairs_to_map or create_map, which only sort once.
+// Iterators are const, since changing a key would break the order.
+// Values are changed via operator[] or at.
+// Can be used wherever fplus expects a map.
+template <typename Key, typename Val, typename Compare = std::less<Key>>
+class flat_map
+{
+public:
+    typedef Key key_type;
+    typedef Val mapped_type;
+    typedef std::pair<Key, Val> value_type;
+    typedef Compare key_compare;
+    typedef std::size_t size_type;
+    typedef typename std::vector<value_type>::const_iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    flat_map() : xs_(), comp_() {}
+
+    flat_map(std::initializer_list<value_type> xs) :
+        flat_map(std::begin(xs), std::end(xs))
+    {
+    }
+
+    // Sorts only once. Keeps the first pair of every key, like std::map.
+    template <typename It>
+    flat_map(It first, It last) : xs_(first, last), comp_()
+    {
+        const auto& comp = comp_;
+        std::stable_sort(std::begin(xs_), std::end(xs_),
+            [&comp](const value_type& a, const value_type& b)
+            {
+                return comp(a.first, b.first);
+            });
+        xs_.erase(std::unique(std::begin(xs_), std::end(xs_),
+            [&comp](const value_type& a, const value_type& b)
+            {
+                return !comp(a.first, b.first);
+            }), std::end(xs_));
+    }
+
+    std::size_t size() const { return xs_.size(); }
+    bool empty() const { return xs_.empty(); }
+    void reserve(std::size_t size) { xs_.reserve(size); }
+    void clear() { xs_.clear(); }
+    key_compare key_comp() const { return comp_; }
+
+    const_iterator begin() const { return std::begin(xs_); }
+    const_iterator end() const { return std::end(xs_); }
+    const_iterator cbegin() const { return std::begin(xs_); }
+    const_iterator cend() const { return std::end(xs_); }
+
+    const_iterator lower_bound(const Key& key) const
+    {
+        return cfind_lower_bound(key);
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        const auto it = lower_bound(key);
+        return it != end() && !comp_(key, it->first) ? it : end();
+    }
+
+    std::size_t count(const Key& key) const
+    {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    const Val& at(const Key& key) const
+    {
+        const auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("flat_map::at");
+        return it->second;
+    }
+    Val& at(const Key& key)
+    {
+        const auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("flat_map::at");
+        return mutable_it(it)->second;
+    }
+
+    Val& operator[](const Key& key)
+    {
+        auto it = mutable_it(lower_bound(key));
+        if (it == std::end(xs_) || comp_(key, it->first))
+            it = xs_.emplace(it, key, Val());
+        return it->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& x)
+    {
+        const auto it = lower_bound(x.first);
+        if (it != end() && !comp_(x.first, it->first))
+            return {it, false};
+        return {xs_.insert(it, x), true};
+    }
+
+    // Appending behind the last key is O(1),
+    // so std::inserter(m, std::end(m)) fills it cheaply from sorted input.
+    iterator insert(const_iterator hint, const value_type& x)
+    {
+        if (hint == cend() && (empty() || comp_(xs_.back().first, x.first)))
+        {
+            xs_.push_back(x);
+            return std::prev(end());
+        }
+        return insert(x).first;
+    }
+    iterator insert(const_iterator hint, value_type&& x)
+    {
+        if (hint == cend() && (empty() || comp_(xs_.back().first, x.first)))
+        {
+            xs_.push_back(std::move(x));
+            return std::prev(end());
+        }
+        return insert(x).first;
+    }
+
+    friend bool operator==(const flat_map& a, const flat_map& b)
+    {
+        return a.xs_ == b.xs_;
+    }
+    friend bool operator!=(const flat_map& a, const flat_map& b)
+    {
+        return a.xs_ != b.xs_;
+    }
+
+private:
+    typename std::vector<value_type>::iterator mutable_it(const_iterator it)
+    {
+        return std::begin(xs_) + (it - std::cbegin(xs_));
+    }
+
+    const_iterator cfind_lower_bound(const Key& key) const
+    {
+        const auto& comp = comp_;
+        return std::lower_bound(std::begin(xs_), std::end(xs_), key,
+            [&comp](const value_type& x, const Key& k)
+            {
+                return comp(x.first, k);
+            });
+    }
+
+    std::vector<value_type> xs_;
+    Compare comp_;
+};
+
+// Set stored as a sorted std::vector without duplicates.
+// The same trade-offs as for flat_map apply.
+// Can be used wherever fplus expects a set.
+// Being random access, it is intersected by galloping in sets_intersection.
+template <typename T, typename Compare = std::less<T>>
+class flat_set
+{
+public:
+    typedef T key_type;
+    typedef T value_type;
+    typedef Compare key_compare;
+    typedef std::size_t size_type;
+    typedef const T& reference;
+    typedef const T& const_reference;
+    typedef typename std::vector<T>::const_iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    flat_set() : xs_(), comp_() {}
+
+    flat_set(std::initializer_list<T> xs) :
+        flat_set(std::begin(xs), std::end(xs))
+    {
+    }
+
+    // Sorts only once.
+    template <typename It>
+    flat_set(It first, It last) : xs_(first, last), comp_()
+    {
+        const auto& comp = comp_;
+        std::sort(std::begin(xs_), std::end(xs_), comp);
+        xs_.erase(std::unique(std::begin(xs_), std::end(xs_),
+            [&comp](const T& a, const T& b)
+            {
+                return !comp(a, b);
+            }), std::end(xs_));
+    }
+
+    std::size_t size() const { return xs_.size(); }
+    bool empty() const { return xs_.empty(); }
+    void reserve(std::size_t size) { xs_.reserve(size); }
+    void clear() { xs_.clear(); }
+    key_compare key_comp() const { return comp_; }
+
+    const_iterator begin() const { return std::begin(xs_); }
+    const_iterator end() const { return std::end(xs_); }
+    const_iterator cbegin() const { return std::begin(xs_); }
+    const_iterator cend() const { return std::end(xs_); }
+
+    const_iterator lower_bound(const T& x) const
+    {
+        return std::lower_bound(std::begin(xs_), std::end(xs_), x, comp_);
+    }
+
+    const_iterator find(const T& x) const
+    {
+        const auto it = lower_bound(x);
+        return it != end() && !comp_(x, *it) ? it : end();
+    }
+
+    std::size_t count(const T& x) const
+    {
+        return find(x) == end() ? 0 : 1;
+    }
+
+    std::pair<const_iterator, bool> insert(const T& x)
+    {
+        const auto it = lower_bound(x);
+        if (it != end() && !comp_(x, *it))
+            return {it, false};
+        return {xs_.insert(it, x), true};
+    }
+
+    // Appending behind the last element is O(1),
+    // so std::inserter(s, std::end(s)) fills it cheaply from sorted input.
+    const_iterator insert(const_iterator hint, const T& x)
+    {
+        if (hint == cend() && (empty() || comp_(xs_.back(), x)))
+        {
+            xs_.push_back(x);
+            return std::prev(end());
+        }
+        return insert(x).first;
+    }
+    const_iterator insert(const_iterator hint, T&& x)
+    {
+        if (hint == cend() && (empty() || comp_(xs_.back(), x)))
+        {
+            xs_.push_back(std::move(x));
+            return std::prev(end());
+        }
+        return insert(x).first;
+    }
+
+    friend bool operator==(const flat_set& a, const flat_set& b)
+    {
+        return a.xs_ == b.xs_;
+    }
+    friend bool operator!=(const flat_set& a, const flat_set& b)
+    {
+        return a.xs_ != b.xs_;
+    }
+    friend bool operator<(const flat_set& a, const flat_set& b)
+    {
+        return a.xs_ < b.xs_;
+    }
+
+private:
+    std::vector<T> xs_;
+    Compare comp_;
+};
+
+namespace internal
+{
+
+template <typename Container>
+struct is_flat_map : public std::false_type {};
+template <typename Key, typename Val, typename Compare>
+struct is_flat_map<flat_map<Key, Val, Compare>> : public std::true_type {};
+
+template <typename Container>
+struct is_flat_set : public std::false_type {};
+template <typename T, typename Compare>
+struct is_flat_set<flat_set<T, Compare>> : public std::true_type {};
+
+template <typename T, typename Compare, typename NewT, int SizeOffset>
+struct same_cont_new_t<flat_set<T, Compare>, NewT, SizeOffset>
+{
+    typedef flat_set<NewT> type;
+};
+
+template <typename Key, typename Val, typename Compare,
+    typename NewKey, typename NewVal>
+struct SameMapTypeNewTypes<flat_map<Key, Val, Compare>, NewKey, NewVal>
+{
+    typedef flat_map<NewKey, NewVal> type;
+};
+
+// Erasing and moving elements in place would break the order.
+template <typename T, typename Compare>
+struct can_reuse<flat_set<T, Compare>>
+{
+    using value = create_new_container_t;
+};
+template <typename Key, typename Val, typename Compare>
+struct can_reuse<flat_map<Key, Val, Compare>>
+{
+    using value = create_new_container_t;
+};
+
+template <typename T, typename Compare>
+void prepare_container(flat_set<T, Compare>& ys, std::size_t size)
+{
+    ys.reserve(size);
+}
+
+template <typename Key, typename Val, typename Compare>
+void prepare_container(flat_map<Key, Val, Compare>& ys, std::size_t size)
+{
+    ys.reserve(size);
+}
+
+} // namespace internal
+
+} // namespace fplus
@@ -13,7 +13,9 @@
 #include <fplus/container_traits.hpp>
 #include <fplus/extrapolate.hpp>
 #include <fplus/filter.hpp>
+#include <fplus/flat_containers.hpp>
 #include <fplus/generate.hpp>
+#include <fplus/instrument.hpp>
 #include <fplus/interpolate.hpp>
 #include <fplus/maps.hpp>
 #include <fplus/maybe.hpp>
@@ -35,6 +37,7 @@
 #include <fplus/tree.hpp>
 #include <fplus/side_effects.hpp>
 #include <fplus/variant.hpp>
+#include <fplus/views.hpp>
 
 #include <fplus/curry.hpp>
 #include <fplus/fwd.hpp>
@@ -12,6 +12,9 @@
 
 #include <fplus/detail/asserts/generate.hpp>
 
+#include <limits>
+#include <stdexcept>
+
 namespace fplus
 {
 
@@ -55,6 +58,19 @@ ContainerOut generate_by_idx(F f, std::size_t amount)
     return ys;
 }
 
+// API search type: generate_by_idx_lazy : ((Int -> a), Int) -> [a]
+// fwd bind count: 1
+// Lazy version of generate_by_idx.
+// f(i) is called every time element i is accessed.
+// generate_by_idx_lazy(f, 3) == [f(0), f(1), f(2)]
+template <typename F>
+view_by_idx<F> generate_by_idx_lazy(F f, std::size_t amount)
+{
+    (void)detail::
+        trigger_static_asserts<detail::generate_by_idx_tag, F, std::size_t>();
+    return view_by_idx<F>(f, amount);
+}
+
 // API search type: repeat : (Int, [a]) -> [a]
 // fwd bind count: 1
 // Create a sequence containing xs concatenated n times.
@@ -66,6 +82,24 @@ Container repeat(std::size_t n, const Container& xs)
     return concat(xss);
 }
 
+// API search type: repeat_lazy : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Lazy version of repeat, storing xs only once.
+// repeat_lazy(3, [1, 2]) == [1, 2, 1, 2, 1, 2]
+template <typename Container>
+auto repeat_lazy(std::size_t n, const Container& xs)
+{
+    typedef typename Container::value_type T;
+    const std::size_t size = size_of_cont(xs);
+    const auto f = [xs, size](std::size_t i) -> T
+    {
+        auto it = std::begin(xs);
+        internal::advance_iterator(it, i % size);
+        return *it;
+    };
+    return view_by_idx<decltype(f)>(f, n * size);
+}
+
 // API search type: infixes : (Int, [a]) -> [[a]]
 // fwd bind count: 1
 // Return als possible infixed of xs with a given length.
@@ -91,6 +125,52 @@ ContainerOut infixes(std::size_t length, const ContainerIn& xs)
     return result;
 }
 
+namespace internal
+{
+
+// Lazy sequence of count windows into xs,
+// window i being the elements [begin_of(i), end_of(i)).
+template <typename Container, typename BeginF, typename EndF>
+auto segments_lazy(const Container& xs, std::size_t count,
+    BeginF begin_of, EndF end_of)
+{
+    static_assert(is_random_access_cont<Container>::value,
+        "Windows need a container with random access.");
+    typedef typename Container::const_iterator It;
+    const It first = std::begin(xs);
+    const auto f = [first, begin_of, end_of](std::size_t i)
+    {
+        return segment_view<It>(
+            internal::add_to_iterator(first, begin_of(i)),
+            internal::add_to_iterator(first, end_of(i)));
+    };
+    return view_by_idx<decltype(f)>(f, count);
+}
+
+} // namespace internal
+
+// API search type: infixes_lazy : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Lazy version of infixes.
+// The infixes are views into xs instead of copies,
+// so xs has to outlive the result.
+// Use materialize to copy an infix.
+// infixes_lazy(3, [1,2,3,4,5,6]) == [[1,2,3], [2,3,4], [3,4,5], [4,5,6]]
+// length must be > 0
+template <typename Container>
+auto infixes_lazy(std::size_t length, const Container& xs)
+{
+    assert(length > 0);
+    const std::size_t xs_size = size_of_cont(xs);
+    return internal::segments_lazy(xs,
+        xs_size < length ? 0 : xs_size - length + 1,
+        [](std::size_t i) { return i; },
+        [length](std::size_t i) { return i + length; });
+}
+
+template <typename Container>
+void infixes_lazy(std::size_t, const Container&&) = delete;
+
 // API search type: carthesian_product_with_where : (((a, b) -> c), ((a -> b), Bool), [a], [b]) -> [c]
 // fwd bind count: 3
 // carthesian_product_with_where(make_pair, always(true), "ABC", "XY")
@@ -199,9 +279,87 @@ ContainerOut carthesian_product(const Container1& xs, const Container2& ys)
 
 namespace internal
 {
-    // productN :: Int -> [a] -> [[a]]
-    // productN n = foldr go [[]] . replicate n
-    //     where go elems acc = [x:xs | x <- elems, xs <- acc]
+    // The digits of a position in the Carthesian product of sets
+    // with the given sizes (a mixed radix number),
+    // the last digit changing fastest.
+    // Incrementing is amortized O(1) and does not allocate.
+    class odometer
+    {
+    public:
+        odometer(std::vector<std::size_t> radices, std::size_t position) :
+            radices_(std::move(radices)), digits_(radices_.size(), 0)
+        {
+            for (std::size_t i = radices_.size(); i-- > 0;)
+            {
+                assert(radices_[i] > 0);
+                digits_[i] = position % radices_[i];
+                position /= radices_[i];
+            }
+        }
+        const std::vector<std::size_t>& digits() const { return digits_; }
+        // Advances to the next position
+        // and returns the index of the first digit that changed.
+        std::size_t increment()
+        {
+            std::size_t i = digits_.size();
+            while (i-- > 0)
+            {
+                if (++digits_[i] < radices_[i])
+                    return i;
+                digits_[i] = 0;
+            }
+            return 0;
+        }
+    private:
+        std::vector<std::size_t> radices_;
+        std::vector<std::size_t> digits_;
+    };
+
+    // Throws if the number of tuples does not fit into an std::size_t.
+    inline std::size_t carthesian_product_n_size(
+        std::size_t power, std::size_t xs_size)
+    {
+        std::size_t result = 1;
+        for (std::size_t i = 0; i < power; ++i)
+        {
+            if (xs_size != 0 &&
+                result > std::numeric_limits<std::size_t>::max() / xs_size)
+            {
+                throw std::overflow_error("carthesian_product_n: too large");
+            }
+            result *= xs_size;
+        }
+        return result;
+    }
+
+    // Calls f with the tuples [begin, end) of the product set,
+    // reusing one buffer, of which only the changed elements are updated.
+    template <typename F, typename T>
+    void for_each_carthesian_product_n(F& f, std::size_t power,
+        const std::vector<T>& xs, std::size_t begin, std::size_t end)
+    {
+        if (begin >= end)
+            return;
+        odometer position(std::vector<std::size_t>(power, xs.size()), begin);
+        const auto& digits = position.digits();
+        std::vector<T> tuple;
+        tuple.reserve(power);
+        for (std::size_t digit : digits)
+        {
+            tuple.push_back(xs[digit]);
+        }
+        for (std::size_t i = begin;;)
+        {
+            detail::invoke(f, static_cast<const std::vector<T>&>(tuple));
+            if (++i == end)
+                return;
+            for (std::size_t j = position.increment(); j < power; ++j)
+            {
+                tuple[j] = xs[digits[j]];
+            }
+        }
+    }
+
     template <typename T>
     std::vector<std::vector<T>> helper_carthesian_product_n_idxs
             (std::size_t power, const std::vector<T>& xs)
@@ -212,19 +370,15 @@ namespace internal
         typedef std::vector<Vec> VecVec;
         if (power == 0)
             return VecVec();
-        auto go = [](const Vec& elems, const VecVec& acc)
+        const std::size_t size = carthesian_product_n_size(power, xs.size());
+        VecVec result;
+        result.reserve(size);
+        const auto push_back = [&result](const Vec& idxs)
         {
-            VecVec result;
-            for (const T& x : elems)
-            {
-                for (const Vec& tail : acc)
-                {
-                    result.push_back(append(Vec(1, x), tail));
-                }
-            }
-            return result;
+            result.push_back(idxs);
         };
-        return fold_right(go, VecVec(1), replicate(power, xs));
+        for_each_carthesian_product_n(push_back, power, xs, 0, size);
+        return result;
     }
 }
 
@@ -233,6 +387,9 @@ namespace internal
 // Returns the product set with a given power.
 // carthesian_product_n(2, "ABCD")
 //   == AA AB AC AD BA BB BC BD CA CB CC CD DA DB DC DD
+// Throws an std::overflow_error if the number of tuples,
+// size(xs)^power, does not fit into an std::size_t.
+// The same holds for all the other carthesian_product_n_* functions.
 template <typename ContainerIn,
     typename T = typename ContainerIn::value_type,
     typename ContainerOut = std::vector<ContainerIn>>
@@ -240,16 +397,94 @@ ContainerOut carthesian_product_n(std::size_t power, const ContainerIn& xs_in)
 {
     if (power == 0)
         return ContainerOut(1);
-    std::vector<T> xs = convert_container<std::vector<T>>(xs_in);
-    auto idxs = all_idxs(xs);
-    auto result_idxss = internal::helper_carthesian_product_n_idxs(power, idxs);
+    const std::vector<T> xs = convert_container<std::vector<T>>(xs_in);
+    const std::size_t size =
+        internal::carthesian_product_n_size(power, xs.size());
     typedef typename ContainerOut::value_type ContainerOutInner;
-    auto to_result_cont = [&](const std::vector<std::size_t>& indices)
+    ContainerOut result;
+    internal::prepare_container(result, size);
+    auto it = internal::get_back_inserter(result);
+    const auto push_back = [&it](const std::vector<T>& tuple)
     {
-        return convert_container_and_elems<ContainerOutInner>(
-            elems_at_idxs(indices, xs));
+        *it = convert_container_and_elems<ContainerOutInner>(tuple);
     };
-    return transform(to_result_cont, result_idxss);
+    internal::for_each_carthesian_product_n(push_back, power, xs, 0, size);
+    return result;
+}
+
+// API search type: carthesian_product_n_lazy : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Lazy version of carthesian_product_n.
+// Every tuple is computed on access,
+// so any one of them can be looked up in O(power).
+// carthesian_product_n_lazy(2, "ABCD")[6] == "BC"
+template <typename ContainerIn,
+    typename T = typename ContainerIn::value_type>
+auto carthesian_product_n_lazy(std::size_t power, const ContainerIn& xs_in)
+{
+    const std::vector<T> xs = convert_container<std::vector<T>>(xs_in);
+    const std::size_t size =
+        internal::carthesian_product_n_size(power, xs.size());
+    const auto f = [power, xs](std::size_t i) -> ContainerIn
+    {
+        const internal::odometer position(
+            std::vector<std::size_t>(power, xs.size()), i);
+        ContainerIn tuple;
+        internal::prepare_container(tuple, power);
+        auto it = internal::get_back_inserter(tuple);
+        for (std::size_t digit : position.digits())
+        {
+            *it = xs[digit];
+        }
+        return tuple;
+    };
+    return view_by_idx<decltype(f)>(f, size);
+}
+
+// API search type: for_each_carthesian_product_n : (([a] -> ()), Int, [a]) -> ()
+// fwd bind count: 2
+// Calls f with every tuple of carthesian_product_n(power, xs), in order.
+// The tuple is passed as an std::vector, which is reused between calls,
+// so the product set is never stored.
+// for_each_carthesian_product_n(print, 2, "AB") prints AA AB BA BB
+template <typename F, typename ContainerIn,
+    typename T = typename ContainerIn::value_type>
+void for_each_carthesian_product_n(F f, std::size_t power,
+    const ContainerIn& xs_in)
+{
+    const std::vector<T> xs = convert_container<std::vector<T>>(xs_in);
+    internal::for_each_carthesian_product_n(f, power, xs, 0,
+        internal::carthesian_product_n_size(power, xs.size()));
+}
+
+// API search type: for_each_carthesian_product_n_parallelly : (([a] -> ()), Int, [a]) -> ()
+// fwd bind count: 2
+// Same as for_each_carthesian_product_n,
+// but splits the product set into one chunk per hardware thread.
+// Calls of f are concurrent and in unspecified order,
+// so f has to be thread-safe.
+// Useful for example for grid searches over huge parameter spaces.
+template <typename F, typename ContainerIn,
+    typename T = typename ContainerIn::value_type>
+void for_each_carthesian_product_n_parallelly(F f, std::size_t power,
+    const ContainerIn& xs_in)
+{
+    const std::vector<T> xs = convert_container<std::vector<T>>(xs_in);
+    const auto positions = numbers_lazy<std::size_t>(0,
+        internal::carthesian_product_n_size(power, xs.size()));
+    typedef typename decltype(positions)::const_iterator It;
+    internal::transform_chunks_parallelly(1 << 12,
+        size_of_cont(positions), std::begin(positions),
+        [f, power, &xs](It chunk_begin, It chunk_end) -> bool
+        {
+            if (chunk_begin == chunk_end)
+                return true;
+            auto f_chunk = f;
+            internal::for_each_carthesian_product_n(f_chunk, power, xs,
+                *chunk_begin, *chunk_begin +
+                    static_cast<std::size_t>(chunk_end - chunk_begin));
+            return true;
+        });
 }
 
 // API search type: permutations : (Int, [a]) -> [[a]]
@@ -373,6 +608,17 @@ ContainerOut iterate(F f, std::size_t size, const T& x)
     return result;
 }
 
+// API search type: iterate_lazy : ((a -> a), Int, a) -> [a]
+// fwd bind count: 2
+// Lazy version of iterate.
+// The values are calculated anew during every pass over the result.
+// iterate_lazy((*2), 5, 3) = [3, 6, 12, 24, 48]
+template <typename F, typename T>
+iterate_view<F, T> iterate_lazy(F f, std::size_t size, const T& x)
+{
+    return iterate_view<F, T>(f, size, x);
+}
+
 // API search type: iterate_maybe : ((a -> Maybe a), a) -> [a]
 // fwd bind count: 1
 // Repeatedly apply a function to a value (starting with x)
@@ -487,6 +733,59 @@ ContainerOut rotations_right(const ContainerIn& xs_in)
     return iterate(rotate_right<ContainerIn>, size_of_cont(xs_in), xs_in);
 }
 
+namespace internal
+{
+
+template <typename Container>
+auto rotations_lazy(bool left, const Container& xs)
+{
+    static_assert(is_random_access_cont<Container>::value,
+        "Rotations need a container with random access.");
+    typedef typename Container::value_type T;
+    const auto first = std::begin(xs);
+    const std::size_t size = size_of_cont(xs);
+    const auto rotation = [left, first, size](std::size_t r)
+    {
+        const std::size_t offset = left ? r : (size - r) % size;
+        const auto f = [first, size, offset](std::size_t i) -> T
+        {
+            return *internal::add_to_iterator(first, (i + offset) % size);
+        };
+        return view_by_idx<decltype(f)>(f, size);
+    };
+    return view_by_idx<decltype(rotation)>(rotation, size);
+}
+
+} // namespace internal
+
+// API search type: rotations_left_lazy : [a] -> [[a]]
+// fwd bind count: 0
+// Lazy version of rotations_left.
+// The rotations are views into xs, so xs has to outlive the result.
+// rotations_left_lazy("abcd") == ["abcd", "bcda", "cdab", "dabc"]
+template <typename Container>
+auto rotations_left_lazy(const Container& xs)
+{
+    return internal::rotations_lazy(true, xs);
+}
+
+template <typename Container>
+void rotations_left_lazy(const Container&&) = delete;
+
+// API search type: rotations_right_lazy : [a] -> [[a]]
+// fwd bind count: 0
+// Lazy version of rotations_right.
+// The rotations are views into xs, so xs has to outlive the result.
+// rotations_right_lazy("abcd") == ["abcd", "dabc", "cdab", "bcda"]
+template <typename Container>
+auto rotations_right_lazy(const Container& xs)
+{
+    return internal::rotations_lazy(false, xs);
+}
+
+template <typename Container>
+void rotations_right_lazy(const Container&&) = delete;
+
 // API search type: fill_left : (a, Int, [a]) -> [a]
 // fwd bind count: 2
 // Right-align a sequence.
@@ -550,4 +849,37 @@ ContainerOut tails(const ContainerIn& xs)
     return result;
 }
 
+// API search type: inits_lazy : [a] -> [[a]]
+// fwd bind count: 0
+// Lazy version of inits.
+// The segments are views into xs, so xs has to outlive the result.
+// inits_lazy([0,1,2,3]) == [[],[0],[0,1],[0,1,2],[0,1,2,3]]
+template <typename Container>
+auto inits_lazy(const Container& xs)
+{
+    return internal::segments_lazy(xs, size_of_cont(xs) + 1,
+        [](std::size_t) -> std::size_t { return 0; },
+        [](std::size_t i) { return i; });
+}
+
+template <typename Container>
+void inits_lazy(const Container&&) = delete;
+
+// API search type: tails_lazy : [a] -> [[a]]
+// fwd bind count: 0
+// Lazy version of tails.
+// The segments are views into xs, so xs has to outlive the result.
+// tails_lazy([0,1,2,3]) == [[0,1,2,3],[1,2,3],[2,3],[3],[]]
+template <typename Container>
+auto tails_lazy(const Container& xs)
+{
+    const std::size_t xs_size = size_of_cont(xs);
+    return internal::segments_lazy(xs, xs_size + 1,
+        [](std::size_t i) { return i; },
+        [xs_size](std::size_t) { return xs_size; });
+}
+
+template <typename Container>
+void tails_lazy(const Container&&) = delete;
+
 } // namespace fplus
@@ -0,0 +1,303 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+// Opt-in profiling of fplus call sites.
+//
+// Define FPLUS_INSTRUMENT before including fplus to count, per function
+// and per thread, the calls, elements processed, heap allocations,
+// bytes allocated, elements copied or moved and the wall time spent.
+// Without it FPLUS_INSTRUMENT_CALL expands to nothing.
+//
+// Numbers are inclusive, i.e. a function calling another instrumented
+// function is charged for its work too.
+// Elements of an input container that is reused (an rvalue)
+// count as moved, elements of every other input as copied.
+// Allocations are only seen if operator new reports them via
+// fplus::instrument::record_allocation. Putting
+// FPLUS_INSTRUMENT_DEFINE_ALLOCATION_HOOKS into exactly one
+// translation unit does that.
+//
+// #define FPLUS_INSTRUMENT
+// #include <fplus/fplus.hpp>
+// FPLUS_INSTRUMENT_DEFINE_ALLOCATION_HOOKS
+// ...
+// std::cout << fplus::instrument::report_table();
+
+#ifdef FPLUS_INSTRUMENT
+
+#include <fplus/container_traits.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+namespace instrument
+{
+
+struct call_stats
+{
+    std::size_t calls;
+    std::size_t elements;
+    std::size_t allocations;
+    std::size_t bytes_allocated;
+    std::size_t elements_copied;
+    std::size_t elements_moved;
+    std::int64_t nanoseconds;
+};
+
+namespace internal
+{
+    inline std::map<std::string, call_stats>& stats_of_thread()
+    {
+        thread_local std::map<std::string, call_stats> stats;
+        return stats;
+    }
+
+    class scope;
+
+    inline scope*& innermost_scope()
+    {
+        thread_local scope* innermost = nullptr;
+        return innermost;
+    }
+
+    // Looks up the stats of a function.
+    // Called only once per call site and thread,
+    // which keeps a reference to the result (see FPLUS_INSTRUMENT_CALL).
+    // The references stay valid, since entries are never erased.
+    // The stack of scopes is detached during the lookup,
+    // so the bookkeeping does not count as an allocation of the caller.
+    inline call_stats& stats_of(const char* name)
+    {
+        scope* const innermost = std::exchange(innermost_scope(), nullptr);
+        call_stats& result = stats_of_thread()[name];
+        innermost_scope() = innermost;
+        return result;
+    }
+
+    // Measures one call and charges it to the stats of its function.
+    // Active scopes of a thread form a stack,
+    // linked through parent_ so that recording needs no allocation.
+    class scope
+    {
+    public:
+        scope(call_stats& stats, std::size_t elements, bool input_reused) :
+            parent_(innermost_scope()),
+            stats_(stats),
+            start_(std::chrono::steady_clock::now())
+        {
+            ++stats_.calls;
+            stats_.elements += elements;
+            if (input_reused)
+                stats_.elements_moved += elements;
+            else
+                stats_.elements_copied += elements;
+            innermost_scope() = this;
+        }
+        ~scope()
+        {
+            const auto duration = std::chrono::steady_clock::now() - start_;
+            stats_.nanoseconds += static_cast<std::int64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    duration).count());
+            innermost_scope() = parent_;
+        }
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+        void record_allocation(std::size_t bytes)
+        {
+            for (scope* s = this; s != nullptr; s = s->parent_)
+            {
+                ++s->stats_.allocations;
+                s->stats_.bytes_allocated += bytes;
+            }
+        }
+    private:
+        scope* parent_;
+        call_stats& stats_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    template <typename Container, typename = void>
+    struct has_size : std::false_type {};
+    template <typename Container>
+    struct has_size<Container, decltype(
+        static_cast<void>(std::declval<const Container&>().size()))> :
+        std::true_type {};
+
+    template <typename Container>
+    std::size_t count_elems(std::true_type, const Container& xs)
+    {
+        return static_cast<std::size_t>(xs.size());
+    }
+
+    // Only forward ranges can be counted without consuming them.
+    template <typename Container>
+    std::size_t count_elems(std::false_type, const Container& xs)
+    {
+        typedef typename std::iterator_traits<
+            decltype(std::begin(xs))>::iterator_category category;
+        return std::is_base_of<std::forward_iterator_tag, category>::value
+            ? static_cast<std::size_t>(
+                std::distance(std::begin(xs), std::end(xs)))
+            : 0;
+    }
+
+    template <typename Container>
+    std::size_t count_elems(const Container& xs)
+    {
+        return count_elems(has_size<Container>(), xs);
+    }
+
+    template <typename Container>
+    bool is_input_reused()
+    {
+        return std::is_same<fplus::internal::can_reuse_v<Container>,
+            fplus::internal::reuse_container_t>::value;
+    }
+} // namespace internal
+
+// Charges an allocation of the given size to all active calls
+// of the current thread. Meant to be called from operator new.
+inline void record_allocation(std::size_t bytes)
+{
+    internal::scope* innermost = internal::innermost_scope();
+    if (innermost != nullptr)
+        innermost->record_allocation(bytes);
+}
+
+// Returns the stats of the current thread,
+// sorted descendingly by the time spent.
+inline std::vector<std::pair<std::string, call_stats>> stats()
+{
+    std::vector<std::pair<std::string, call_stats>> result;
+    for (const auto& entry : internal::stats_of_thread())
+    {
+        if (entry.second.calls != 0)
+            result.push_back(entry);
+    }
+    std::stable_sort(std::begin(result), std::end(result),
+        [](const auto& a, const auto& b)
+        {
+            return a.second.nanoseconds > b.second.nanoseconds;
+        });
+    return result;
+}
+
+// Forgets all stats of the current thread.
+// The entries are only zeroed, since call sites keep references to them.
+inline void reset()
+{
+    for (auto& entry : internal::stats_of_thread())
+    {
+        entry.second = call_stats();
+    }
+}
+
+// Renders the stats of the current thread as a fixed-width table.
+inline std::string report_table()
+{
+    std::ostringstream out;
+    out << std::left << std::setw(28) << "function" << std::right
+        << std::setw(10) << "calls"
+        << std::setw(12) << "elements"
+        << std::setw(10) << "allocs"
+        << std::setw(14) << "bytes"
+        << std::setw(12) << "copied"
+        << std::setw(12) << "moved"
+        << std::setw(12) << "ms" << "\n";
+    for (const auto& entry : stats())
+    {
+        const call_stats& s = entry.second;
+        out << std::left << std::setw(28) << entry.first << std::right
+            << std::setw(10) << s.calls
+            << std::setw(12) << s.elements
+            << std::setw(10) << s.allocations
+            << std::setw(14) << s.bytes_allocated
+            << std::setw(12) << s.elements_copied
+            << std::setw(12) << s.elements_moved
+            << std::setw(12) << std::fixed << std::setprecision(3)
+            << static_cast<double>(s.nanoseconds) / 1000000.0 << "\n";
+    }
+    return out.str();
+}
+
+// Renders the stats of the current thread as a JSON array.
+inline std::string report_json()
+{
+    std::ostringstream out;
+    out << "[";
+    bool first = true;
+    for (const auto& entry : stats())
+    {
+        const call_stats& s = entry.second;
+        out << (first ? "" : ",")
+            << "{\"function\":\"" << entry.first << "\""
+            << ",\"calls\":" << s.calls
+            << ",\"elements\":" << s.elements
+            << ",\"allocations\":" << s.allocations
+            << ",\"bytes_allocated\":" << s.bytes_allocated
+            << ",\"elements_copied\":" << s.elements_copied
+            << ",\"elements_moved\":" << s.elements_moved
+            << ",\"nanoseconds\":" << s.nanoseconds << "}";
+        first = false;
+    }
+    out << "]";
+    return out.str();
+}
+
+} // namespace instrument
+
+} // namespace fplus
+
+#define FPLUS_INSTRUMENT_CALL(name, Container, xs) \
+    static thread_local ::fplus::instrument::call_stats& \
+        fplus_instrument_stats = \
+            ::fplus::instrument::internal::stats_of(name); \
+    ::fplus::instrument::internal::scope fplus_instrument_scope( \
+        fplus_instrument_stats, \
+        ::fplus::instrument::internal::count_elems(xs), \
+        ::fplus::instrument::internal::is_input_reused<Container>())
+
+#define FPLUS_INSTRUMENT_DEFINE_ALLOCATION_HOOKS \
+void* operator new(std::size_t size) \
+{ \
+    ::fplus::instrument::record_allocation(size); \
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) \
+        return ptr; \
+    throw std::bad_alloc(); \
+} \
+void operator delete(void* ptr) noexcept \
+{ \
+    std::free(ptr); \
+} \
+void operator delete(void* ptr, std::size_t) noexcept \
+{ \
+    std::free(ptr); \
+}
+
+#else
+
+#define FPLUS_INSTRUMENT_CALL(name, Container, xs)
+#define FPLUS_INSTRUMENT_DEFINE_ALLOCATION_HOOKS
+
+#endif
@@ -18,15 +18,80 @@
 namespace fplus
 {
 
+namespace internal
+{
+
+template <typename MapOut, typename ContainerIn>
+MapOut pairs_to_map(std::false_type, const ContainerIn& pairs)
+{
+    return convert_container_and_elems<MapOut>(pairs);
+}
+
+template <typename MapOut, typename ContainerIn>
+MapOut pairs_to_map(std::true_type, const ContainerIn& pairs)
+{
+    return MapOut(std::begin(pairs), std::end(pairs));
+}
+
+} // namespace internal
+
 // API search type: pairs_to_map : [(key, val)] -> Map key val
 // fwd bind count: 0
 // Converts a Container of pairs (key, value) into a dictionary.
 template <typename MapOut, typename ContainerIn>
 MapOut pairs_to_map(const ContainerIn& pairs)
 {
-    return convert_container_and_elems<MapOut>(pairs);
+    return internal::pairs_to_map<MapOut>(
+        internal::is_flat_map<MapOut>{}, pairs);
+}
+
+namespace internal
+{
+
+template <typename MapOut, typename ContainerIn>
+MapOut pairs_to_map_grouped(std::false_type, const ContainerIn& pairs)
+{
+    MapOut result;
+    for (const auto& p : pairs)
+    {
+        result[p.first].push_back(p.second);
+    }
+    return result;
+}
+
+// Sorts the pairs by key once and appends every group.
+template <typename MapOut, typename ContainerIn>
+MapOut pairs_to_map_grouped(std::true_type, const ContainerIn& pairs)
+{
+    typedef typename ContainerIn::value_type Pair;
+    std::vector<Pair> sorted(std::begin(pairs), std::end(pairs));
+    const auto comp = MapOut().key_comp();
+    const auto key_less = [&comp](const Pair& a, const Pair& b)
+    {
+        return comp(a.first, b.first);
+    };
+    std::stable_sort(std::begin(sorted), std::end(sorted), key_less);
+    MapOut result;
+    auto it = std::begin(sorted);
+    while (it != std::end(sorted))
+    {
+        const auto group_end =
+            std::upper_bound(it, std::end(sorted), *it, key_less);
+        typename MapOut::mapped_type group;
+        internal::prepare_container(group,
+            static_cast<std::size_t>(group_end - it));
+        for (auto group_it = it; group_it != group_end; ++group_it)
+        {
+            group.push_back(group_it->second);
+        }
+        result.insert(std::end(result), {it->first, std::move(group)});
+        it = group_end;
+    }
+    return result;
 }
 
+} // namespace internal
+
 // API search type: pairs_to_map_grouped : [(key, val)] -> Map key [val]
 // fwd bind count: 0
 // Convert a list of key-value pairs to a dictionary
@@ -39,12 +104,8 @@ template <typename ContainerIn,
     typename MapOut = std::map<Key, std::vector<SingleValue>>>
 MapOut pairs_to_map_grouped(const ContainerIn& pairs)
 {
-    MapOut result;
-    for (const auto& p : pairs)
-    {
-        result[p.first].push_back(p.second);
-    }
-    return result;
+    return internal::pairs_to_map_grouped<MapOut>(
+        internal::is_flat_map<MapOut>{}, pairs);
 }
 
 // API search type: map_to_pairs : Map key val -> [(key, val)]
@@ -80,20 +141,97 @@ auto transform_map_values(F f, const MapIn& map)
             map_to_pairs(map)));
 }
 
+namespace internal
+{
+
+// Both maps are sorted by key, so they are merged in one pass,
+// appending every key at the end of the result.
+template <typename F, typename MapIn, typename MapOut>
+void merge_sorted_maps_with(F f,
+    const MapIn& dict1, const MapIn& dict2, MapOut& result)
+{
+    const auto comp = dict1.key_comp();
+    auto it1 = std::begin(dict1);
+    auto it2 = std::begin(dict2);
+    while (it1 != std::end(dict1) || it2 != std::end(dict2))
+    {
+        if (it2 == std::end(dict2) ||
+            (it1 != std::end(dict1) && comp(it1->first, it2->first)))
+        {
+            result.insert(std::end(result), *it1);
+            ++it1;
+        }
+        else if (it1 == std::end(dict1) || comp(it2->first, it1->first))
+        {
+            result.insert(std::end(result), *it2);
+            ++it2;
+        }
+        else
+        {
+            result.insert(std::end(result), {it1->first,
+                detail::invoke(f, it1->second, it2->second)});
+            ++it1;
+            ++it2;
+        }
+    }
+}
+
+template <typename F, typename Key, typename Val,
+    typename Compare, typename Alloc>
+std::map<Key, Val, Compare, Alloc> map_union_with(F f,
+    const std::map<Key, Val, Compare, Alloc>& dict1,
+    const std::map<Key, Val, Compare, Alloc>& dict2)
+{
+    std::map<Key, Val, Compare, Alloc> result(
+        dict1.key_comp(), dict1.get_allocator());
+    merge_sorted_maps_with(f, dict1, dict2, result);
+    return result;
+}
+
+template <typename F, typename Key, typename Val, typename Compare>
+flat_map<Key, Val, Compare> map_union_with(F f,
+    const flat_map<Key, Val, Compare>& dict1,
+    const flat_map<Key, Val, Compare>& dict2)
+{
+    flat_map<Key, Val, Compare> result;
+    result.reserve(dict1.size() + dict2.size());
+    merge_sorted_maps_with(f, dict1, dict2, result);
+    return result;
+}
+
+// Copies the first map and probes it for every key of the second one.
+template <typename F, typename Key, typename Val,
+    typename Hash, typename Pred, typename Alloc>
+std::unordered_map<Key, Val, Hash, Pred, Alloc> map_union_with(F f,
+    const std::unordered_map<Key, Val, Hash, Pred, Alloc>& dict1,
+    const std::unordered_map<Key, Val, Hash, Pred, Alloc>& dict2)
+{
+    std::unordered_map<Key, Val, Hash, Pred, Alloc> result(
+        dict1.size() + dict2.size(), dict1.hash_function(), dict1.key_eq(),
+        dict1.get_allocator());
+    result.insert(std::begin(dict1), std::end(dict1));
+    for (const auto& key_and_val : dict2)
+    {
+        const auto it = result.find(key_and_val.first);
+        if (it == std::end(result))
+            result.insert(key_and_val);
+        else
+            it->second = detail::invoke(f, it->second, key_and_val.second);
+    }
+    return result;
+}
+
+} // namespace internal
+
 // API search type: map_union_with : (((val, val) -> val), Map key val, Map key val) -> Map key val
 // fwd bind count: 2
 // Combine two dictionaries using a binary function for the values.
 // map_union_with((++), {0: a, 1: b}, {0: c, 2: d}) == {0: ac, 1: b, 2: d}
+// Takes one pass over both dictionaries.
 template <typename F, typename MapIn>
 auto map_union_with(F f, const MapIn& dict1, const MapIn& dict2)
 {
-    auto full_map = pairs_to_map_grouped(
-            append(map_to_pairs(dict1), map_to_pairs(dict2)));
-    const auto group_f = [f](const auto& vals)
-    {
-        return fold_left_1(f, vals);
-    };
-    return transform_map_values(group_f, full_map);
+    return internal::map_union_with(f, dict1, dict2);
 }
 
 // API search type: map_union : (Map key val, Map key val) -> Map key val
@@ -285,7 +423,7 @@ MapType map_keep_if(Pred pred, const MapType& map)
     {
         if (pred(key_and_value.first))
         {
-            result.insert(key_and_value);
+            result.insert(std::end(result), key_and_value);
         }
     }
     return result;
@@ -15,6 +15,8 @@
 #include <exception>
 #include <functional>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace fplus
 {
@@ -53,11 +55,24 @@ public:
     {
         new (&mem_[0]) T(val_just);
     }
+    maybe(T&& val_just)
+        noexcept(std::is_nothrow_move_constructible<T>::value) :
+        is_present_(true), mem_({})
+    {
+        new (&mem_[0]) T(std::move(val_just));
+    }
     maybe(const maybe<T>& other) : is_present_(other.is_just()), mem_({})
     {
         if (other.is_just())
             new (&mem_[0]) T(other.unsafe_get_just());
     }
+    maybe(maybe<T>&& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value) :
+        is_present_(other.is_just()), mem_({})
+    {
+        if (other.is_just())
+            new (&mem_[0]) T(std::move(other.unsafe_get_just()));
+    }
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
@@ -606,9 +606,11 @@ Container normalize_min_max(internal::reuse_container_t,
 {
     assert(size_of_cont(xs) != 0);
     assert(lower <= upper);
-    const auto minmax_it_p = std::minmax_element(std::begin(xs), std::end(xs));
-    const T x_min = *minmax_it_p.first;
-    const T x_max = *minmax_it_p.second;
+    const auto x_min_max = internal::minmax(
+        internal::use_lane_kernel<T, internal::remove_const_and_ref_t<
+            Container>>(), xs);
+    const T x_min = x_min_max.first;
+    const T x_max = x_min_max.second;
     const auto f = [&](const T& x) -> T
     {
         return lower + (upper - lower) * (x - x_min) / (x_max - x_min);
@@ -638,6 +640,7 @@ template <typename Container,
     typename T = typename internal::remove_const_and_ref_t<Container>::value_type>
 ContainerOut normalize_min_max(const T& lower, const T& upper, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("normalize_min_max", Container, xs);
     return internal::normalize_min_max(internal::can_reuse_v<Container>{},
         lower, upper, std::forward<Container>(xs));
 }
@@ -645,17 +648,46 @@ ContainerOut normalize_min_max(const T& lower, const T& upper, Container&& xs)
 namespace internal
 {
 
+// Floating point values are multiplied by a precomputed scale.
+// Integral values keep dividing per element,
+// because a scale in T would be truncated.
+template <typename T>
+struct mean_stddev_scaler
+{
+    T mean;
+    T stddev;
+    T x_mean;
+    T x_stddev;
+    T scale;
+    T operator()(const T& x) const
+    {
+        return scale_value(std::is_floating_point<T>(), x);
+    }
+    T scale_value(std::true_type, const T& x) const
+    {
+        return mean + (x - x_mean) * scale;
+    }
+    T scale_value(std::false_type, const T& x) const
+    {
+        return mean + stddev * (x - x_mean) / x_stddev;
+    }
+};
+
+template <typename T, typename Container>
+mean_stddev_scaler<T> make_mean_stddev_scaler(
+    const T& mean, const T& stddev, const Container& xs)
+{
+    assert(size_of_cont(xs) != 0);
+    const auto mean_and_stddev = fplus::mean_stddev<T>(xs);
+    return {mean, stddev, mean_and_stddev.first, mean_and_stddev.second,
+        stddev / mean_and_stddev.second};
+}
+
 template <typename Container, typename T>
 Container normalize_mean_stddev(internal::reuse_container_t,
     const T& mean, const T& stddev, Container&& xs)
 {
-    assert(size_of_cont(xs) != 0);
-    const auto mean_and_stddev = fplus::mean_stddev<T>(xs);
-    const auto f = [&](const T& x) -> T
-    {
-        return mean +
-            stddev * (x - mean_and_stddev.first) / mean_and_stddev.second;
-    };
+    const auto f = make_mean_stddev_scaler(mean, stddev, xs);
     std::transform(std::begin(xs), std::end(xs), std::begin(xs), f);
     return std::forward<Container>(xs);
 }
@@ -664,9 +696,12 @@ template <typename Container, typename T>
 Container normalize_mean_stddev(internal::create_new_container_t,
     const T& mean, const T& stddev, const Container& xs)
 {
-    auto ys = xs;
-    return normalize_mean_stddev(internal::reuse_container_t(),
-        mean, stddev, std::move(ys));
+    const auto f = make_mean_stddev_scaler(mean, stddev, xs);
+    Container ys;
+    internal::prepare_container(ys, size_of_cont(xs));
+    std::transform(std::begin(xs), std::end(xs),
+        internal::get_back_inserter<Container>(ys), f);
+    return ys;
 }
 
 } // namespace internal
@@ -682,6 +717,7 @@ template <typename Container,
 ContainerOut normalize_mean_stddev(
     const T& mean, const T& stddev, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("normalize_mean_stddev", Container, xs);
     return internal::normalize_mean_stddev(internal::can_reuse_v<Container>{},
         mean, stddev, std::forward<Container>(xs));
 }
@@ -690,6 +726,7 @@ ContainerOut normalize_mean_stddev(
 // fwd bind count: 0
 // Linearly scales the values to zero mean and population standard deviation 1.
 // standardize([7, 8]) == [-1, 1]
+// Works in place if xs is an rvalue.
 template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut standardize(Container&& xs)
@@ -748,11 +785,197 @@ std::function<X(X)> divide_by(const X& x)
     };
 }
 
+namespace internal
+{
+    // Half-open range of the indices of the bins containing a value.
+    typedef std::pair<std::size_t, std::size_t> bin_idx_range;
+
+    // Shared counting kernel of the histogram functions
+    // and fill_pigeonholes_to.
+    template <typename Counts, typename InputIt, typename BinsOf>
+    void add_to_bin_counts(Counts& counts,
+        InputIt it, InputIt it_end, BinsOf bins_of)
+    {
+        for (; it != it_end; ++it)
+        {
+            const bin_idx_range bins = bins_of(*it);
+            for (std::size_t i = bins.first; i < bins.second; ++i)
+            {
+                ++counts[i];
+            }
+        }
+    }
+
+    template <typename Counts, typename Container, typename BinsOf>
+    Counts bin_counts(std::size_t bin_count,
+        const Container& xs, BinsOf bins_of)
+    {
+        Counts counts(bin_count, 0);
+        add_to_bin_counts(counts, std::begin(xs), std::end(xs), bins_of);
+        return counts;
+    }
+
+    // Every thread counts its chunk of xs into its own partial histogram.
+    template <typename Counts, typename Container, typename BinsOf>
+    Counts bin_counts_parallelly(std::size_t bin_count,
+        const Container& xs, BinsOf bins_of)
+    {
+        typedef decltype(std::begin(xs)) It;
+        const auto partial_counts = transform_chunks_parallelly(1 << 16,
+            size_of_cont(xs), std::begin(xs),
+            [bin_count, bins_of](It chunk_begin, It chunk_end)
+            {
+                std::vector<std::size_t> counts(bin_count, 0);
+                add_to_bin_counts(counts, chunk_begin, chunk_end, bins_of);
+                return counts;
+            });
+        Counts counts(bin_count, 0);
+        for (const auto& partial : partial_counts)
+        {
+            for (std::size_t i = 0; i < bin_count; ++i)
+            {
+                counts[i] += partial[i];
+            }
+        }
+        return counts;
+    }
+
+    // Bins with non-decreasing lower and upper bounds.
+    // The bins containing x are the ones with
+    // an upper bound above x (a suffix) and a lower bound not above x
+    // (a prefix), so both ends of the range are found using binary search.
+    // Overlapping bins (e.g. from rounding errors) are handled correctly.
+    template <typename T>
+    struct sorted_interval_bins
+    {
+        std::vector<T> lowers;
+        std::vector<T> uppers;
+
+        bin_idx_range operator()(const T& x) const
+        {
+            const std::size_t end = static_cast<std::size_t>(std::distance(
+                lowers.begin(),
+                std::upper_bound(lowers.begin(), lowers.end(), x)));
+            const std::size_t begin = static_cast<std::size_t>(std::distance(
+                uppers.begin(),
+                std::upper_bound(uppers.begin(), uppers.end(), x)));
+            return {begin, std::max(begin, end)};
+        }
+    };
+
+    // Sorted bins with lower bounds close to origin + i * width.
+    // The arithmetic guess of the bin is corrected
+    // by a short local search, so the result matches the actual bounds.
+    template <typename T>
+    struct uniform_interval_bins
+    {
+        sorted_interval_bins<T> bins;
+        T origin;
+        T width;
+
+        // Returns the number of bounds not above x,
+        // starting the search at idx.
+        static std::size_t count_not_above(const std::vector<T>& bounds,
+            const T& x, std::size_t idx)
+        {
+            while (idx > 0 && x < bounds[idx - 1])
+                --idx;
+            while (idx < bounds.size() && !(x < bounds[idx]))
+                ++idx;
+            return idx;
+        }
+
+        bin_idx_range operator()(const T& x) const
+        {
+            const std::size_t size = bins.lowers.size();
+            std::size_t guess = 0;
+            if (origin <= x)
+            {
+                const auto bin_idx = (x - origin) / width;
+                guess = bin_idx < static_cast<T>(size)
+                    ? static_cast<std::size_t>(bin_idx) + 1
+                    : size;
+            }
+            const std::size_t end = count_not_above(bins.lowers, x, guess);
+            const std::size_t begin = count_not_above(
+                bins.uppers, x, guess == 0 ? 0 : guess - 1);
+            return {begin, std::max(begin, end)};
+        }
+    };
+
+    template <typename ContainerIntervals,
+        typename T = typename ContainerIntervals::value_type::first_type>
+    sorted_interval_bins<T> make_sorted_interval_bins(
+        const ContainerIntervals& intervals)
+    {
+        sorted_interval_bins<T> bins = {{}, {}};
+        bins.lowers.reserve(size_of_cont(intervals));
+        bins.uppers.reserve(size_of_cont(intervals));
+        for (const auto& interval : intervals)
+        {
+            bins.lowers.push_back(interval.first);
+            bins.uppers.push_back(interval.second);
+        }
+        return bins;
+    }
+
+    template <typename Counts, typename ContainerIntervals,
+        typename ContainerIn>
+    Counts interval_bin_counts(bool parallelly,
+        const ContainerIntervals& intervals, const ContainerIn& xs)
+    {
+        auto bins = make_sorted_interval_bins(intervals);
+        if (std::is_sorted(bins.lowers.begin(), bins.lowers.end()) &&
+            std::is_sorted(bins.uppers.begin(), bins.uppers.end()))
+        {
+            return parallelly
+                ? bin_counts_parallelly<Counts>(
+                    size_of_cont(intervals), xs, std::move(bins))
+                : bin_counts<Counts>(
+                    size_of_cont(intervals), xs, std::move(bins));
+        }
+        // Arbitrary bins, every element is tested against every bin.
+        Counts counts(size_of_cont(intervals), 0);
+        for (const auto& x : xs)
+        {
+            std::size_t i = 0;
+            for (const auto& interval : intervals)
+            {
+                if (x >= interval.first && x < interval.second)
+                {
+                    ++counts[i];
+                }
+                ++i;
+            }
+        }
+        return counts;
+    }
+
+    template <typename ContainerOut, typename ContainerIntervals>
+    ContainerOut zip_intervals_and_counts(const ContainerIntervals& intervals,
+        const std::vector<std::size_t>& counts)
+    {
+        ContainerOut bins;
+        internal::prepare_container(bins, size_of_cont(intervals));
+        auto itOut = internal::get_back_inserter(bins);
+        std::size_t i = 0;
+        for (const auto& interval : intervals)
+        {
+            *itOut = std::make_pair(interval, counts[i]);
+            ++i;
+        }
+        return bins;
+    }
+} // namespace internal
+
 // API search type: histogram_using_intervals : ([(a, a)], [a]) -> [((a, a), Int)]
 // fwd bind count: 1
 // Generate a histogram of a sequence with given bins.
 // histogram_using_intervals([(0,4), (4,5), (6,8)], [0,1,4,5,6,7,8,9]) ==
 //     [((0, 4), 2), ((4, 5), 1), ((6, 8), 2)]
+// If the lower and the upper bounds of the intervals are sorted,
+// the bins of every element are found using binary search,
+// i.e., O(n * log(bins)), otherwise O(n * bins).
 template <typename ContainerIn,
         typename ContainerIntervals,
         typename ContainerOut =
@@ -764,50 +987,106 @@ template <typename ContainerIn,
 ContainerOut histogram_using_intervals(
         const ContainerIntervals& intervals, const ContainerIn& xs)
 {
-    ContainerOut bins;
-    internal::prepare_container(bins, size_of_cont(intervals));
-    auto itOut = internal::get_back_inserter(bins);
-    for (const auto& interval : intervals)
-    {
-        *itOut = std::make_pair(interval, 0);
-    }
-    for (const auto& x : xs)
-    {
-        for (auto& bin : bins)
-        {
-            if (x >= bin.first.first && x < bin.first.second)
-            {
-                ++bin.second;
-            }
-        }
-    }
-    return bins;
+    FPLUS_INSTRUMENT_CALL("histogram_using_intervals", const ContainerIn&, xs);
+    return internal::zip_intervals_and_counts<ContainerOut>(intervals,
+        internal::interval_bin_counts<std::vector<std::size_t>>(
+            false, intervals, xs));
+}
+
+// API search type: histogram_using_intervals_parallelly : ([(a, a)], [a]) -> [((a, a), Int)]
+// fwd bind count: 1
+// Same as histogram_using_intervals, but can utilize multiple CPUs
+// by counting chunks of xs into partial histograms using std::async.
+// Only sorted intervals are counted in parallel.
+template <typename ContainerIn,
+        typename ContainerIntervals,
+        typename ContainerOut =
+            std::vector<
+                std::pair<
+                    typename ContainerIntervals::value_type,
+                    std::size_t>>,
+        typename T = typename ContainerIn::value_type>
+ContainerOut histogram_using_intervals_parallelly(
+        const ContainerIntervals& intervals, const ContainerIn& xs)
+{
+    return internal::zip_intervals_and_counts<ContainerOut>(intervals,
+        internal::interval_bin_counts<std::vector<std::size_t>>(
+            true, intervals, xs));
 }
 
 // API search type: generate_consecutive_intervals : (a, a, a) -> [(a, a)]
 // fwd bind count: 2
 // Return intervals of a given size adjacent to each other
 // generate_consecutive_intervals(0, 2, 4) == [(0,2), (2,4), (4,6), (6,8)]
+// The bounds are calculated by multiplication instead of repeated addition,
+// so floating-point rounding errors do not accumulate.
 template <typename T>
 std::vector<std::pair<T, T>> generate_consecutive_intervals(
         const T& first_lower_bound, const T& step, std::size_t count)
 {
-    const auto count_as_T = static_cast<T>(count);
-    return zip(
-        numbers_step<T>(
-            first_lower_bound,
-            first_lower_bound + count_as_T * step,
-            step),
-        numbers_step<T>(
-            first_lower_bound + step,
-            first_lower_bound + step + count_as_T * step,
-            step));
+    std::vector<std::pair<T, T>> result;
+    result.reserve(count);
+    T lower_bound = first_lower_bound;
+    for (std::size_t i = 1; i <= count; ++i)
+    {
+        const T upper_bound = static_cast<T>(
+            first_lower_bound + static_cast<T>(i) * step);
+        result.emplace_back(lower_bound, upper_bound);
+        lower_bound = upper_bound;
+    }
+    return result;
 }
 
+namespace internal
+{
+    template <typename ContainerOut, typename ContainerIn, typename T>
+    ContainerOut histogram(bool parallelly,
+        const T& first_center, const T& bin_width, std::size_t count,
+        const ContainerIn& xs)
+    {
+        const T first_lower_bound = first_center - bin_width / 2;
+        const auto intervals = generate_consecutive_intervals(
+            first_lower_bound, bin_width, count);
+        assert(size_of_cont(intervals) == count);
+
+        std::vector<std::size_t> counts;
+        auto bins = make_sorted_interval_bins(intervals);
+        if (bin_width > 0 &&
+            std::is_sorted(bins.lowers.begin(), bins.lowers.end()) &&
+            std::is_sorted(bins.uppers.begin(), bins.uppers.end()))
+        {
+            const uniform_interval_bins<T> uniform_bins =
+                {std::move(bins), first_lower_bound, bin_width};
+            counts = parallelly
+                ? bin_counts_parallelly<std::vector<std::size_t>>(
+                    count, xs, uniform_bins)
+                : bin_counts<std::vector<std::size_t>>(
+                    count, xs, uniform_bins);
+        }
+        else
+        {
+            counts = interval_bin_counts<std::vector<std::size_t>>(
+                parallelly, intervals, xs);
+        }
+
+        ContainerOut histo;
+        internal::prepare_container(histo, count);
+        auto itOut = internal::get_back_inserter(histo);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& interval = intervals[i];
+            const auto current_center = (interval.first + interval.second) / 2;
+            *itOut = std::make_pair(current_center, counts[i]);
+        }
+        return histo;
+    }
+} // namespace internal
+
 // API search type: histogram : (a, a, a, [a]) -> [((a, a), Int)]
 // fwd bind count: 3
 // Calculate the histogram of a sequence using a given bin width.
 // histogram(1, 2, 4, [0,1,4,5,7,8,9]) == [(1, 2), (3, 0), (5, 2), (7, 1)]
+// The bin of every element is calculated arithmetically, i.e., O(n).
 template <typename ContainerIn,
         typename ContainerOut =
             std::vector<
@@ -819,24 +1098,27 @@ ContainerOut histogram(
         const T& first_center, const T& bin_width, std::size_t count,
         const ContainerIn& xs)
 {
-    const auto interval_histogram = histogram_using_intervals(
-        generate_consecutive_intervals(
-            first_center - bin_width / 2,
-            bin_width,
-            count),
-        xs);
-
-    assert(size_of_cont(interval_histogram) == count);
+    return internal::histogram<ContainerOut>(
+        false, first_center, bin_width, count, xs);
+}
 
-    ContainerOut histo;
-    internal::prepare_container(histo, count);
-    auto itOut = internal::get_back_inserter(histo);
-    for (const auto& bin : interval_histogram)
-    {
-        const auto current_center = (bin.first.first + bin.first.second) / 2;
-        *itOut = std::make_pair(current_center, bin.second);
-    }
-    return histo;
+// API search type: histogram_parallelly : (a, a, a, [a]) -> [((a, a), Int)]
+// fwd bind count: 3
+// Same as histogram, but can utilize multiple CPUs
+// by counting chunks of xs into partial histograms using std::async.
+template <typename ContainerIn,
+        typename ContainerOut =
+            std::vector<
+                std::pair<
+                    typename ContainerIn::value_type,
+                    std::size_t>>,
+        typename T = typename ContainerIn::value_type>
+ContainerOut histogram_parallelly(
+        const T& first_center, const T& bin_width, std::size_t count,
+        const ContainerIn& xs)
+{
+    return internal::histogram<ContainerOut>(
+        true, first_center, bin_width, count, xs);
 }
 
 // API search type: modulo_chain : ([Int], Int) -> [Int]
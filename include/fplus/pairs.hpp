@@ -431,19 +431,58 @@ TOut inner_product_with(OP1 op1,
         std::begin(xs), std::end(xs), std::begin(ys), value, op1, op2);
 }
 
+namespace internal
+{
+    // The multiplication and the addition are not fused with std::fma,
+    // because it is a slow library call on targets without FMA instructions.
+    template <typename T>
+    struct inner_product_lane_op
+    {
+        typedef lane_acc_t<T> Acc;
+        const T* xs;
+        const T* ys;
+        void operator()(Acc& acc, std::size_t idx) const
+        {
+            acc = static_cast<Acc>(acc +
+                static_cast<Acc>(xs[idx]) * static_cast<Acc>(ys[idx]));
+        }
+        Acc combine(Acc a, Acc b) const { return static_cast<Acc>(a + b); }
+    };
+
+    template <typename ContainerIn1, typename ContainerIn2, typename Z>
+    Z inner_product(std::true_type, const Z& value,
+        const ContainerIn1& xs, const ContainerIn2& ys)
+    {
+        return reduce_lanes<Z>(size_of_cont(xs), value, lane_acc_t<Z>(),
+            inner_product_lane_op<Z>{xs.data(), ys.data()});
+    }
+
+    template <typename ContainerIn1, typename ContainerIn2, typename Z>
+    Z inner_product(std::false_type, const Z& value,
+        const ContainerIn1& xs, const ContainerIn2& ys)
+    {
+        return std::inner_product(
+            std::begin(xs), std::end(xs), std::begin(ys), value);
+    }
+} // namespace internal
+
 // API search type: inner_product : (a, [a], [a]) -> a
 // fwd bind count: 2
 // Calculate the inner product of two sequences.
 // inner_product([1, 2, 3], [4, 5, 6]) == [32]
+// Like sum, arithmetic values in std::vector and std::array
+// are processed using multiple accumulators.
 template <typename ContainerIn1, typename ContainerIn2,
     typename Z>
 Z inner_product(const Z& value,
         const ContainerIn1& xs, const ContainerIn2& ys)
 {
     assert(size_of_cont(xs) == size_of_cont(ys));
-
-    return std::inner_product(
-        std::begin(xs), std::end(xs), std::begin(ys), value);
+    return internal::inner_product<ContainerIn1, ContainerIn2, Z>(
+        std::integral_constant<bool,
+            internal::use_lane_kernel<Z, ContainerIn1>::value &&
+            internal::use_lane_kernel<Z, ContainerIn2>::value>(),
+        value, xs, ys);
 }
 
 // API search type: first_mismatch_idx_by : (((a, b) -> Bool), [a], [b]) -> Maybe Int
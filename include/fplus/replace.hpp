@@ -44,6 +44,7 @@ template <typename UnaryPredicate, typename Container,
 ContainerOut replace_if(UnaryPredicate p,
     const typename ContainerOut::value_type& dest, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("replace_if", Container, xs);
     return internal::replace_if(internal::can_reuse_v<Container>{},
         p, dest, std::forward<Container>(xs));
 }
@@ -85,6 +86,7 @@ template <typename Container,
 ContainerOut replace_elem_at_idx(std::size_t idx, const T& dest,
     Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("replace_elem_at_idx", Container, xs);
     return internal::replace_elem_at_idx(internal::can_reuse_v<Container>{},
         idx, dest, std::forward<Container>(xs));
 }
@@ -39,6 +39,9 @@ public:
     const Ok& unsafe_get_ok() const {
         check_either_or_invariant(); assert(is_ok()); return *ptr_ok_;
     }
+    Ok& unsafe_get_ok() {
+        check_either_or_invariant(); assert(is_ok()); return *ptr_ok_;
+    }
     const Error& unsafe_get_error() const {
         check_either_or_invariant(); assert(is_error()); return *ptr_error_;
     }
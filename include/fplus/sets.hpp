@@ -41,17 +41,46 @@ bool unordered_set_includes(const UnorderSetType& set1,
     return first_not_included == set2.end();
 }
 
+namespace internal
+{
+
+// A flat_set would search for every duplicate of std::merge.
+template <typename SetType>
+void set_merge(std::true_type, const SetType& set1, const SetType& set2,
+    SetType& result)
+{
+    std::set_union(std::begin(set1), std::end(set1),
+        std::begin(set2), std::end(set2),
+        internal::get_back_inserter(result));
+}
+
+// Sets decide themselves which duplicates to keep,
+// e.g. a std::multiset or a sorted std::vector keeps all of them.
+template <typename SetType>
+void set_merge(std::false_type, const SetType& set1, const SetType& set2,
+    SetType& result)
+{
+    std::merge(std::begin(set1), std::end(set1),
+        std::begin(set2), std::end(set2),
+        internal::get_back_inserter(result));
+}
+
+} // namespace internal
+
 // API search type: set_merge : (Set a, Set a) -> Set a
 // fwd bind count: 1
 // Returns the union of two given sets.
+// Like the other set_* functions, this takes one pass over both sets
+// and also works with sorted std::vectors.
+// Merging std::multisets or sorted std::vectors keeps all elements of both.
 template <typename SetType>
 SetType set_merge(const SetType& set1, const SetType& set2)
 {
     SetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::merge(std::begin(set1), std::end(set1),
-        std::begin(set2), std::end(set2),
-        itOut);
+    internal::prepare_container(result,
+        size_of_cont(set1) + size_of_cont(set2));
+    internal::set_merge(internal::is_flat_set<SetType>(),
+        set1, set2, result);
     return result;
 }
 
@@ -75,6 +104,8 @@ template <typename SetType>
 SetType set_intersection(const SetType& set1, const SetType& set2)
 {
     SetType result;
+    internal::prepare_container(result,
+        std::min(size_of_cont(set1), size_of_cont(set2)));
     auto itOut = internal::get_back_inserter(result);
     std::set_intersection(std::begin(set1), std::end(set1),
         std::begin(set2), std::end(set2),
@@ -123,6 +154,7 @@ template <typename SetType>
 SetType set_difference(const SetType& set1, const SetType& set2)
 {
     SetType result;
+    internal::prepare_container(result, size_of_cont(set1));
     auto itOut = internal::get_back_inserter(result);
     std::set_difference(std::begin(set1), std::end(set1),
         std::begin(set2), std::end(set2),
@@ -153,6 +185,8 @@ template <typename SetType>
 SetType set_symmetric_difference(const SetType& set1, const SetType& set2)
 {
     SetType result;
+    internal::prepare_container(result,
+        size_of_cont(set1) + size_of_cont(set2));
     auto itOut = internal::get_back_inserter(result);
     std::set_symmetric_difference(std::begin(set1), std::end(set1),
         std::begin(set2), std::end(set2),
@@ -178,27 +212,169 @@ UnorderSetType unordered_set_symmetric_difference(
     return result;
 }
 
+namespace internal
+{
+
+// Returns the first position in [first, last) not less than x.
+// Probes 1, 2, 4, ... elements ahead before searching binarily,
+// so it is cheap if that position is close to first.
+template <typename It, typename T>
+It gallop_lower_bound(It first, It last, const T& x)
+{
+    typedef typename std::iterator_traits<It>::difference_type diff_t;
+    if (first == last || !(*first < x))
+        return first;
+    It lo = first;
+    diff_t step = 1;
+    while (step < last - lo)
+    {
+        const It probe = lo + step;
+        if (!(*probe < x))
+            return std::lower_bound(lo + 1, probe, x);
+        lo = probe;
+        step *= 2;
+    }
+    return std::lower_bound(lo + 1, last, x);
+}
+
+template <typename SetType, typename = void>
+struct has_lower_bound_member : std::false_type {};
+template <typename SetType>
+struct has_lower_bound_member<SetType, detail::void_t<
+    decltype(std::declval<const SetType&>().lower_bound(
+        std::declval<const typename SetType::value_type&>()))>> :
+    std::true_type {};
+
+// Tree-based sets, e.g. std::set, take a few steps forward first,
+// since the next element is often close,
+// and only then search from the root in O(log(n)).
+template <typename SetType, typename It, typename T>
+It advance_to_without_random_access(std::true_type, const SetType& set,
+    It first, It last, const T& x)
+{
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        if (first == last || !(*first < x))
+            return first;
+        ++first;
+    }
+    return set.lower_bound(x);
+}
+
+template <typename SetType, typename It, typename T>
+It advance_to_without_random_access(std::false_type, const SetType&,
+    It first, It last, const T& x)
+{
+    while (first != last && *first < x)
+        ++first;
+    return first;
+}
+
+template <typename SetType, typename It, typename T>
+It advance_to(std::true_type, const SetType&, It first, It last, const T& x)
+{
+    return gallop_lower_bound(first, last, x);
+}
+
+template <typename SetType, typename It, typename T>
+It advance_to(std::false_type, const SetType& set,
+    It first, It last, const T& x)
+{
+    return advance_to_without_random_access(
+        has_lower_bound_member<SetType>{}, set, first, last, x);
+}
+
+// Intersects sorted sets by looking up the elements of the smallest one
+// in the others, whose cursors only move forward.
+template <typename SetType, typename ContainerIn>
+SetType sorted_sets_intersection(const ContainerIn& sets)
+{
+    assert(is_not_empty(sets));
+    typedef typename SetType::const_iterator It;
+    std::vector<const SetType*> by_size;
+    by_size.reserve(size_of_cont(sets));
+    for (const auto& set : sets)
+    {
+        by_size.push_back(&set);
+    }
+    std::stable_sort(std::begin(by_size), std::end(by_size),
+        [](const SetType* a, const SetType* b)
+        {
+            return size_of_cont(*a) < size_of_cont(*b);
+        });
+    std::vector<It> cursors;
+    cursors.reserve(by_size.size());
+    for (const SetType* set : by_size)
+    {
+        cursors.push_back(std::begin(*set));
+    }
+    SetType result;
+    auto itOut = internal::get_back_inserter(result);
+    for (const auto& x : *by_size.front())
+    {
+        bool in_all = true;
+        for (std::size_t i = 1; i < by_size.size() && in_all; ++i)
+        {
+            const It end = std::end(*by_size[i]);
+            cursors[i] = advance_to(is_random_access_cont<SetType>{},
+                *by_size[i], cursors[i], end, x);
+            if (cursors[i] == end)
+                return result;
+            in_all = !(x < *cursors[i]);
+        }
+        if (in_all)
+            *itOut = x;
+    }
+    return result;
+}
+
+} // namespace internal
+
 // API search type: sets_intersection : [Set a] -> Set a
 // fwd bind count: 0
 // Returns the intersection of the given sets.
 // Also known as intersect_many.
-// For performance try to sort the inputs sets prior, ascendending by size.
+// Only the smallest set is iterated, and its elements are looked up
+// in the other sets in ascending order.
+// Sets with random access, e.g. sorted vectors, are searched by galloping,
+// and sets with a lower_bound member, e.g. std::set, by that member,
+// which is fast if the sizes of the sets differ a lot.
 template <typename ContainerIn,
     typename SetType = typename ContainerIn::value_type>
 SetType sets_intersection(const ContainerIn& sets)
 {
-    return fold_left_1(set_intersection<SetType>, sets);
+    return internal::sorted_sets_intersection<SetType>(sets);
 }
 
 // API search type: unordered_sets_intersection : [Unordered_Set a] -> Unordered_Set a
 // fwd bind count: 0
 // Returns the intersection of the given unordered_sets.
 // Also known as intersect_many.
+// Only the smallest set is iterated, and its elements are looked up
+// in the other sets.
 template <typename ContainerIn,
     typename UnordSetType = typename ContainerIn::value_type>
 UnordSetType unordered_sets_intersection(const ContainerIn& sets)
 {
-    return fold_left_1(unordered_set_intersection<UnordSetType>, sets);
+    assert(is_not_empty(sets));
+    const UnordSetType& smallest = *std::min_element(
+        std::begin(sets), std::end(sets),
+        [](const UnordSetType& a, const UnordSetType& b)
+        {
+            return a.size() < b.size();
+        });
+    UnordSetType result;
+    for (const auto& x : smallest)
+    {
+        const bool in_all = std::all_of(std::begin(sets), std::end(sets),
+            [&x](const UnordSetType& set) -> bool
+            {
+                return set.find(x) != std::end(set);
+            });
+        if (in_all)
+            result.insert(x);
+    }
+    return result;
 }
 
 } // namespace fplus
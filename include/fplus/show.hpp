@@ -11,14 +11,306 @@
 #include <fplus/maybe.hpp>
 #include <fplus/transform.hpp>
 
+#include <cassert>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <ios>
+#include <limits>
+#include <locale>
 #include <sstream>
 #include <string>
+#include <type_traits>
+
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#endif
+#endif
 
 namespace fplus
 {
 
+namespace internal
+{
+    // The show functions write into one growing buffer
+    // instead of creating and joining a temporary string per element.
+    // Arithmetic values are formatted without constructing
+    // a std::ostringstream. Since streams respect the global locale
+    // (grouping, decimal point), this shortcut is only taken
+    // if the global locale is the classic one,
+    // so the output stays identical to streaming the value.
+    // Without std::to_chars, floating-point values are printed by snprintf,
+    // which follows the C locale (std::setlocale) instead,
+    // so its decimal point has to be a dot too.
+    struct show_buffer
+    {
+        std::string& str;
+        bool classic_locale;
+    };
+
+    inline bool is_global_locale_classic()
+    {
+#if defined(__cpp_lib_to_chars)
+        return std::locale() == std::locale::classic();
+#else
+        return std::locale() == std::locale::classic() &&
+            std::strcmp(std::localeconv()->decimal_point, ".") == 0;
+#endif
+    }
+
+    struct show_integer_tag {};
+    struct show_floating_point_tag {};
+    struct show_stream_tag {};
+
+    // Character types and bool are printed differently by streams,
+    // so they are not treated as numbers here.
+    template <typename T>
+    using show_tag_t = typename std::conditional<
+        std::is_integral<T>::value &&
+            !std::is_same<T, bool>::value &&
+            !std::is_same<T, char>::value &&
+            !std::is_same<T, signed char>::value &&
+            !std::is_same<T, unsigned char>::value &&
+            !std::is_same<T, wchar_t>::value &&
+            !std::is_same<T, char16_t>::value &&
+            !std::is_same<T, char32_t>::value,
+        show_integer_tag,
+        typename std::conditional<
+            std::is_floating_point<T>::value,
+            show_floating_point_tag,
+            show_stream_tag>::type>::type;
+
+    template <typename T>
+    void append_integer(std::string& str, T x)
+    {
+        typedef typename std::make_unsigned<T>::type U;
+        char digits[std::numeric_limits<U>::digits10 + 2];
+        char* const digits_end = digits + sizeof(digits);
+        char* it = digits_end;
+        const bool is_negative = x < 0;
+        // Negating in unsigned arithmetic also works for the minimum value.
+        U magnitude = is_negative
+            ? static_cast<U>(U(0) - static_cast<U>(x))
+            : static_cast<U>(x);
+        do
+        {
+            *--it = static_cast<char>('0' + magnitude % 10);
+            magnitude = static_cast<U>(magnitude / 10);
+        } while (magnitude != 0);
+        if (is_negative)
+        {
+            str.push_back('-');
+        }
+        str.append(it, digits_end);
+    }
+
+#if defined(__cpp_lib_to_chars)
+    template <typename T>
+    void append_float(std::string& str, T x, bool fixed, int precision)
+    {
+        const auto format =
+            fixed ? std::chars_format::fixed : std::chars_format::general;
+        const std::size_t pos = str.size();
+        std::size_t room = 32 + static_cast<std::size_t>(precision);
+        for (;;)
+        {
+            str.resize(pos + room);
+            char* const first = &str[pos];
+            const auto res =
+                std::to_chars(first, first + room, x, format, precision);
+            if (res.ec == std::errc())
+            {
+                str.resize(pos + static_cast<std::size_t>(res.ptr - first));
+                return;
+            }
+            room *= 2;
+        }
+    }
+#else
+    inline int print_float(char* buf, std::size_t size,
+        bool fixed, int precision, double x)
+    {
+        return fixed
+            ? std::snprintf(buf, size, "%.*f", precision, x)
+            : std::snprintf(buf, size, "%.*g", precision, x);
+    }
+
+    inline int print_float(char* buf, std::size_t size,
+        bool fixed, int precision, long double x)
+    {
+        return fixed
+            ? std::snprintf(buf, size, "%.*Lf", precision, x)
+            : std::snprintf(buf, size, "%.*Lg", precision, x);
+    }
+
+    template <typename T>
+    void append_float(std::string& str, T x, bool fixed, int precision)
+    {
+        // float is promoted to double, just like std::num_put does it.
+        typedef typename std::conditional<
+            std::is_same<T, long double>::value, long double, double>::type
+            Printed;
+        const std::size_t pos = str.size();
+        std::size_t room = 32 + static_cast<std::size_t>(precision);
+        for (;;)
+        {
+            // snprintf always writes a terminating null character.
+            str.resize(pos + room + 1);
+            const int written = print_float(&str[pos], room + 1,
+                fixed, precision, static_cast<Printed>(x));
+            assert(written >= 0);
+            const std::size_t length = static_cast<std::size_t>(written);
+            if (length <= room)
+            {
+                str.resize(pos + length);
+                return;
+            }
+            room = length;
+        }
+    }
+#endif
+
+    template <typename T>
+    void show_to_buffer(const show_buffer& buf, const T& x);
+
+    inline void show_to_buffer(const show_buffer& buf, const std::string& str);
+
+    template <typename X, typename Y>
+    void show_to_buffer(const show_buffer& buf, const std::pair<X, Y>& p);
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::vector<T, A>& xs);
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::list<T, A>& xs);
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::set<T, A>& xs);
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::deque<T, A>& xs);
+
+    template <typename Container>
+    void show_cont_to_buffer(const show_buffer& buf,
+        const std::string& separator,
+        const std::string& prefix, const std::string& suffix,
+        const Container& xs,
+        std::size_t new_line_every_nth_elem);
+
+    template <typename T>
+    void show_value_to_buffer(show_stream_tag,
+        const show_buffer& buf, const T& x)
+    {
+        std::ostringstream ss;
+        ss << x;
+        buf.str += ss.str();
+    }
+
+    template <typename T>
+    void show_value_to_buffer(show_integer_tag,
+        const show_buffer& buf, const T& x)
+    {
+        if (buf.classic_locale)
+            append_integer(buf.str, x);
+        else
+            show_value_to_buffer(show_stream_tag(), buf, x);
+    }
+
+    template <typename T>
+    void show_value_to_buffer(show_floating_point_tag,
+        const show_buffer& buf, const T& x)
+    {
+        // std::ostream defaults to precision 6 without fixed or scientific,
+        // which corresponds to printf's %.6g.
+        if (buf.classic_locale)
+            append_float(buf.str, x, false, 6);
+        else
+            show_value_to_buffer(show_stream_tag(), buf, x);
+    }
+
+    template <typename T>
+    void show_to_buffer(const show_buffer& buf, const T& x)
+    {
+        show_value_to_buffer(show_tag_t<T>(), buf, x);
+    }
+
+    inline void show_to_buffer(const show_buffer& buf, const std::string& str)
+    {
+        buf.str += str;
+    }
+
+    template <typename X, typename Y>
+    void show_to_buffer(const show_buffer& buf, const std::pair<X, Y>& p)
+    {
+        buf.str.push_back('(');
+        show_to_buffer(buf, p.first);
+        buf.str += ", ";
+        show_to_buffer(buf, p.second);
+        buf.str.push_back(')');
+    }
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::vector<T, A>& xs)
+    {
+        show_cont_to_buffer(buf, ", ", "[", "]", xs, 0);
+    }
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::list<T, A>& xs)
+    {
+        show_cont_to_buffer(buf, ", ", "[", "]", xs, 0);
+    }
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::set<T, A>& xs)
+    {
+        show_cont_to_buffer(buf, ", ", "[", "]", xs, 0);
+    }
+
+    template <typename T, typename A>
+    void show_to_buffer(const show_buffer& buf, const std::deque<T, A>& xs)
+    {
+        show_cont_to_buffer(buf, ", ", "[", "]", xs, 0);
+    }
+
+    template <typename Container>
+    void show_cont_to_buffer(const show_buffer& buf,
+        const std::string& separator,
+        const std::string& prefix, const std::string& suffix,
+        const Container& xs,
+        std::size_t new_line_every_nth_elem)
+    {
+        buf.str += prefix;
+        std::size_t i = 0;
+        for (const auto& x : xs)
+        {
+            if (i != 0)
+            {
+                buf.str += separator;
+                if (new_line_every_nth_elem != 0 &&
+                    i % new_line_every_nth_elem == 0)
+                {
+                    buf.str.push_back('\n');
+                    buf.str.append(prefix.size(), ' ');
+                }
+            }
+            show_to_buffer(buf, x);
+            ++i;
+        }
+        buf.str += suffix;
+    }
+
+    template <typename T>
+    std::string show_to_string(const T& x)
+    {
+        std::string result;
+        show_to_buffer(show_buffer{result, is_global_locale_classic()}, x);
+        return result;
+    }
+} // namespace internal
+
 // API search type: show : a -> String
 // fwd bind count: 0
 // 42 -> "42"
@@ -32,9 +324,7 @@ namespace fplus
 template <typename T>
 std::string show(const T& x)
 {
-    std::ostringstream ss;
-    ss << x;
-    return ss.str();
+    return internal::show_to_string(x);
 }
 
 // string identity
@@ -45,43 +335,35 @@ std::string show(const std::string& str)
     return str;
 }
 
-template <typename T, typename A>
-std::string show(const std::vector<T, A>& xs);
-
-template <typename T, typename A>
-std::string show(const std::list<T, A>& xs);
-
 // {1, "one"} -> "(1, one)"
 template <typename X, typename Y>
 std::string show(const std::pair<X, Y>& p)
 {
-    return std::string("(") + show(p.first) + ", " + show(p.second) + ")";
+    return internal::show_to_string(p);
 }
 
-template <typename Container> std::string show_cont(const Container& xs);
-
 template <typename T, typename A>
 std::string show(const std::vector<T, A>& xs)
 {
-    return show_cont(xs);
+    return internal::show_to_string(xs);
 }
 
 template <typename T, typename A>
 std::string show(const std::list<T, A>& xs)
 {
-    return show_cont(xs);
+    return internal::show_to_string(xs);
 }
 
 template <typename T, typename A>
 std::string show(const std::set<T, A>& xs)
 {
-    return show_cont(xs);
+    return internal::show_to_string(xs);
 }
 
 template <typename T, typename A>
 std::string show(const std::deque<T, A>& xs)
 {
-    return show_cont(xs);
+    return internal::show_to_string(xs);
 }
 
 // API search type: show_cont_with_frame_and_newlines : (String, String, String, [a], Int) -> String
@@ -97,30 +379,13 @@ std::string show_cont_with_frame_and_newlines(
     const Container& xs,
     std::size_t new_line_every_nth_elem )
 {
-    std::vector<std::string> elemStrs;
-    elemStrs.reserve(xs.size());
-    if (new_line_every_nth_elem == 0)
-    {
-        for (const auto& x : xs)
-        {
-            elemStrs.push_back(show(x));
-        }
-    }
-    else
-    {
-        std::size_t i = 0;
-        std::string newline =
-            std::string("\n") + std::string(prefix.size(), ' ');
-        for (const auto& x : xs)
-        {
-            if ( i && i % new_line_every_nth_elem == 0)
-                elemStrs.push_back(newline + show(x));
-            else
-                elemStrs.push_back(show(x));
-            ++i;
-        }
-    }
-    return prefix + join(separator, elemStrs) + suffix;
+    std::string result;
+    result.reserve(prefix.size() + suffix.size() +
+        size_of_cont(xs) * (separator.size() + 1));
+    internal::show_cont_to_buffer(
+        internal::show_buffer{result, internal::is_global_locale_classic()},
+        separator, prefix, suffix, xs, new_line_every_nth_elem);
+    return result;
 }
 
 // API search type: show_cont_with_frame : (String, String, String, [a]) -> String
@@ -180,6 +445,31 @@ std::string show_result(const result<Ok, Error>& result)
         return std::string("Ok " + show(unsafe_get_ok(result)));
 }
 
+namespace internal
+{
+    template <typename T, typename Tag>
+    void show_fixed_to_buffer(Tag, const show_buffer& buf,
+        std::size_t right_char_count, const T& x)
+    {
+        std::ostringstream ss;
+        ss
+            << std::fixed
+            << std::setprecision(static_cast<int>(right_char_count))
+            << x;
+        buf.str += ss.str();
+    }
+
+    template <typename T>
+    void show_fixed_to_buffer(show_floating_point_tag, const show_buffer& buf,
+        std::size_t right_char_count, const T& x)
+    {
+        if (buf.classic_locale)
+            append_float(buf.str, x, true, static_cast<int>(right_char_count));
+        else
+            show_fixed_to_buffer(show_stream_tag(), buf, right_char_count, x);
+    }
+} // namespace internal
+
 // API search type: show_float : (Int, Int, Float) -> String
 // fwd bind count: 2
 // Can be used to show floating point values in a specific format
@@ -211,17 +501,20 @@ std::string show_float(
         is_negative && min_left_chars > 0
         ? min_left_chars - 1
         : min_left_chars;
-    std::stringstream stream;
-    stream
-        << std::fixed
-        << std::setprecision(static_cast<int>(right_char_count))
-        << std::abs(x);
-    std::string s = stream.str();
-    std::size_t min_dest_length = min_left_chars_final + 1 + right_char_count;
-    std::string result = fill_left('0', min_dest_length, s);
+    std::string result;
     if (is_negative)
     {
-        result = std::string("-") + result;
+        result.push_back('-');
+    }
+    const std::size_t digits_begin = result.size();
+    internal::show_fixed_to_buffer(internal::show_tag_t<T>(),
+        internal::show_buffer{result, internal::is_global_locale_classic()},
+        right_char_count, std::abs(x));
+    const std::size_t digits_length = result.size() - digits_begin;
+    std::size_t min_dest_length = min_left_chars_final + 1 + right_char_count;
+    if (digits_length < min_dest_length)
+    {
+        result.insert(digits_begin, min_dest_length - digits_length, '0');
     }
     return result;
 }
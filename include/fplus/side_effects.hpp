@@ -12,20 +12,35 @@
 #include <fplus/string_tools.hpp>
 #include <fplus/detail/invoke.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <cassert>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <future>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <streambuf>
 #include <string>
 #include <thread>
 #include <vector>
 
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#define FPLUS_POSIX_FILE_IO
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 namespace fplus
 {
 
@@ -327,6 +342,413 @@ std::function<void()> execute_fire_and_forget(Effect eff)
     };
 }
 
+namespace internal
+{
+    // Read-only content of a file.
+    // Regular files are mapped into memory (POSIX) if possible,
+    // so no copy of the data is made.
+    // Pipes, special files and files on other platforms
+    // are read in chunks into a heap buffer instead.
+    class file_content
+    {
+    public:
+        // Returns nullptr if the file could not be opened or read.
+        static std::shared_ptr<const file_content> open(
+            const std::string& filename)
+        {
+            std::shared_ptr<file_content> result(new file_content());
+            if (!result->load(filename))
+                return nullptr;
+            return result;
+        }
+        ~file_content()
+        {
+#ifdef FPLUS_POSIX_FILE_IO
+            if (mapping_ != nullptr)
+                ::munmap(mapping_, size_);
+#endif
+        }
+        file_content(const file_content&) = delete;
+        file_content& operator=(const file_content&) = delete;
+        const char* data() const { return data_; }
+        std::size_t size() const { return size_; }
+    private:
+        file_content() :
+            data_(nullptr), size_(0), mapping_(nullptr), buffer_()
+        {
+        }
+        void use_buffer()
+        {
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+#ifdef FPLUS_POSIX_FILE_IO
+        bool load(const std::string& filename)
+        {
+            const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return false;
+            const bool success = load_mapped(fd) || load_buffered(fd);
+            ::close(fd);
+            return success;
+        }
+        bool load_mapped(int fd)
+        {
+            // Files reporting a size of 0, like the ones in /proc,
+            // can still have content, so they are read normally.
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+                info.st_size <= 0)
+                return false;
+            const std::size_t size = static_cast<std::size_t>(info.st_size);
+            void* mapping =
+                ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+                return false;
+            ::posix_madvise(mapping, size, POSIX_MADV_SEQUENTIAL);
+            mapping_ = mapping;
+            data_ = static_cast<const char*>(mapping);
+            size_ = size;
+            return true;
+        }
+        bool load_buffered(int fd)
+        {
+            const std::size_t chunk_size = 1 << 16;
+            std::size_t used = 0;
+            for (;;)
+            {
+                buffer_.resize(used + chunk_size);
+                const ::ssize_t count = ::read(fd, &buffer_[used], chunk_size);
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count < 0)
+                    return false;
+                if (count == 0)
+                    break;
+                used += static_cast<std::size_t>(count);
+            }
+            buffer_.resize(used);
+            use_buffer();
+            return true;
+        }
+#else
+        bool load(const std::string& filename)
+        {
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.good())
+                return false;
+            buffer_.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+            use_buffer();
+            return true;
+        }
+#endif
+        const char* data_;
+        std::size_t size_;
+        void* mapping_;
+        std::vector<char> buffer_;
+    };
+} // namespace internal
+
+// Read-only view of the content of a file,
+// holding shared ownership of the underlying memory,
+// so copies are cheap.
+// T is char for text and std::uint8_t for binary data.
+// Provides begin/end/size and value_type,
+// so it can be passed to the fplus functions reading a container,
+// e.g., count, sum, find_first_idx, is_infix_of, transform or keep_if,
+// the latter two returning a std::vector.
+// convert_container<std::string>(view) creates an owning copy.
+template <typename T>
+class file_view
+{
+public:
+    static_assert(sizeof(T) == 1, "Only byte-sized elements are supported.");
+    typedef T value_type;
+    typedef const T& reference;
+    typedef const T& const_reference;
+    typedef const T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<const_iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    file_view() : content_() {}
+    explicit file_view(std::shared_ptr<const internal::file_content> content) :
+        content_(std::move(content))
+    {
+    }
+    const T* data() const
+    {
+        return content_
+            ? reinterpret_cast<const T*>(content_->data())
+            : nullptr;
+    }
+    std::size_t size() const { return content_ ? content_->size() : 0; }
+    bool empty() const { return size() == 0; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+    const T& operator[](std::size_t idx) const
+    {
+        assert(idx < size());
+        return data()[idx];
+    }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size() - 1]; }
+private:
+    std::shared_ptr<const internal::file_content> content_;
+};
+
+template <typename T>
+bool operator == (const file_view<T>& xs, const file_view<T>& ys)
+{
+    return xs.size() == ys.size() &&
+        std::equal(xs.begin(), xs.end(), ys.begin());
+}
+
+template <typename T>
+bool operator != (const file_view<T>& xs, const file_view<T>& ys)
+{
+    return !(xs == ys);
+}
+
+namespace internal
+{
+    template <typename T>
+    struct has_order<file_view<T>> : public std::true_type {};
+
+    // Results of a file_view (e.g. of transform or keep_if) are stored
+    // in a std::vector, since a view can not own new elements.
+    template <typename T, typename NewT, int SizeOffset>
+    struct same_cont_new_t<file_view<T>, NewT, SizeOffset>
+    {
+        typedef typename std::vector<NewT> type;
+    };
+
+    // A view can not be modified, so even rvalues are never reused.
+    template <typename T>
+    struct can_reuse<file_view<T>>
+    {
+        using value = create_new_container_t;
+    };
+
+    template <typename T>
+    struct materialized<file_view<T>>
+    {
+        typedef std::vector<T> type;
+    };
+
+    template <typename T>
+    maybe<file_view<T>> read_file_view_maybe(const std::string& filename)
+    {
+        auto content = internal::file_content::open(filename);
+        if (!content)
+            return {};
+        return file_view<T>(std::move(content));
+    }
+
+    // Splits [begin, end) into lines with the same semantics as
+    // split_lines(allow_empty, clean_newlines(...)),
+    // i.e. "\r\n", "\r" and "\n" are line breaks,
+    // without creating a cleaned copy of the whole text first.
+    template <typename Iterator, typename F>
+    void for_each_line(bool allow_empty, Iterator begin, Iterator end, F f)
+    {
+        if (allow_empty && begin == end)
+        {
+            f(begin, end);
+            return;
+        }
+        auto start = begin;
+        while (start != end)
+        {
+            const auto stop = std::find_if(start, end, [](char c)
+            {
+                return c == '\n' || c == '\r';
+            });
+            if (start != stop || allow_empty)
+                f(start, stop);
+            if (stop == end)
+                break;
+            start = std::next(stop);
+            if (*stop == '\r' && start != end && *start == '\n')
+                ++start;
+            if (allow_empty && start == end)
+                f(end, end);
+        }
+    }
+} // namespace internal
+
+// API search type: read_text_file_view_maybe : String -> Io (Maybe FileView)
+// Returns a function that (when called) provides
+// read-only access to the content of a text file.
+// On POSIX systems regular files are memory-mapped instead of copied,
+// so the file must not be truncated while a view of it exists
+// (accessing the lost part raises SIGBUS).
+// No newline conversion is done.
+inline
+std::function<maybe<file_view<char>>()> read_text_file_view_maybe(
+    const std::string& filename)
+{
+    return [filename]() -> maybe<file_view<char>>
+    {
+        return internal::read_file_view_maybe<char>(filename);
+    };
+}
+
+// API search type: read_text_file_view : String -> Io FileView
+// Returns a function that (when called) provides
+// read-only access to the content of a text file.
+// This function then returns an empty view if the file could not be read.
+inline
+std::function<file_view<char>()> read_text_file_view(
+    const std::string& filename)
+{
+    return [filename]() -> file_view<char>
+    {
+        return just_with_default(file_view<char>(),
+            internal::read_file_view_maybe<char>(filename));
+    };
+}
+
+// API search type: read_binary_file_view_maybe : String -> Io (Maybe FileView)
+// Returns a function that (when called) provides
+// read-only access to the content of a binary file.
+// On POSIX systems regular files are memory-mapped instead of copied,
+// so the file must not be truncated while a view of it exists
+// (accessing the lost part raises SIGBUS).
+inline
+std::function<maybe<file_view<std::uint8_t>>()> read_binary_file_view_maybe(
+    const std::string& filename)
+{
+    return [filename]() -> maybe<file_view<std::uint8_t>>
+    {
+        return internal::read_file_view_maybe<std::uint8_t>(filename);
+    };
+}
+
+// API search type: read_binary_file_view : String -> Io FileView
+// Returns a function that (when called) provides
+// read-only access to the content of a binary file.
+// This function then returns an empty view if the file could not be read.
+inline
+std::function<file_view<std::uint8_t>()> read_binary_file_view(
+    const std::string& filename)
+{
+    return [filename]() -> file_view<std::uint8_t>
+    {
+        return just_with_default(file_view<std::uint8_t>(),
+            internal::read_file_view_maybe<std::uint8_t>(filename));
+    };
+}
+
+namespace internal
+{
+    // Limits the number of bytes being read at the same time.
+    // A request larger than the capacity is granted
+    // as soon as nothing else is in flight.
+    // A capacity of 0 means no limit.
+    class byte_budget
+    {
+    public:
+        explicit byte_budget(std::size_t capacity) :
+            capacity_(capacity), in_flight_(0), mutex_(), cond_()
+        {
+        }
+        void acquire(std::size_t bytes)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this, bytes]() -> bool
+            {
+                return capacity_ == 0 || in_flight_ == 0 ||
+                    in_flight_ + bytes <= capacity_;
+            });
+            in_flight_ += bytes;
+        }
+        void release(std::size_t bytes)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                in_flight_ -= bytes;
+            }
+            cond_.notify_all();
+        }
+    private:
+        const std::size_t capacity_;
+        std::size_t in_flight_;
+        std::mutex mutex_;
+        std::condition_variable cond_;
+    };
+
+    // Reads a whole file into a std::string or std::vector<std::uint8_t>.
+    // Regular files are read with one allocation of the right size.
+    template <typename Container>
+    bool read_file_into(const std::string& filename, bool binary,
+        byte_budget& budget, Container& out)
+    {
+#ifdef FPLUS_POSIX_FILE_IO
+        (void)binary;
+        const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+            info.st_size > 0)
+        {
+            const std::size_t size = static_cast<std::size_t>(info.st_size);
+            budget.acquire(size);
+            out.resize(size);
+            std::size_t used = 0;
+            bool success = true;
+            while (used < size)
+            {
+                const ::ssize_t count = ::read(fd,
+                    reinterpret_cast<char*>(&out[0]) + used, size - used);
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                {
+                    success = count == 0;
+                    break;
+                }
+                used += static_cast<std::size_t>(count);
+            }
+            budget.release(size);
+            ::close(fd);
+            out.resize(used);
+            return success;
+        }
+        ::close(fd);
+        // Pipes, special files and files in /proc.
+        const auto content = file_content::open(filename);
+        if (!content)
+            return false;
+        out.assign(content->data(), content->data() + content->size());
+        return true;
+#else
+        (void)budget;
+        std::ifstream file(filename, binary
+            ? std::ios::in | std::ios::binary
+            : std::ios::in);
+        if (!file.good())
+            return false;
+        out.assign(std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>());
+        return true;
+#endif
+    }
+} // namespace internal
+
 // API search type: read_text_file_maybe : String -> Io (Maybe String)
 // Returns a function that reads the content of a text file when called.
 inline
@@ -335,12 +757,21 @@ std::function<maybe<std::string>()> read_text_file_maybe(
 {
     return [filename]() -> maybe<std::string>
     {
+#ifdef FPLUS_POSIX_FILE_IO
+        internal::byte_budget no_limit(0);
+        std::string content;
+        if (!internal::read_file_into(filename, false, no_limit, content))
+            return {};
+        return just(std::move(content));
+#else
+        // Text mode, so newlines are converted as usual on this platform.
         std::ifstream input(filename);
         if (!input.good())
             return {};
         return just(std::string(
                 std::istreambuf_iterator<std::string::value_type>(input),
                 std::istreambuf_iterator<std::string::value_type>()));
+#endif
     };
 }
 
@@ -367,19 +798,12 @@ std::function<maybe<std::vector<std::uint8_t>>()> read_binary_file_maybe(
 {
     return [filename]() -> maybe<std::vector<std::uint8_t>>
     {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.good())
+        internal::byte_budget no_limit(0);
+        std::vector<std::uint8_t> content;
+        if (!internal::read_file_into(filename, true, no_limit, content) ||
+            content.empty())
             return {};
-        file.unsetf(std::ios::skipws);
-        std::streampos fileSize;
-        file.seekg(0, std::ios::end);
-        fileSize = file.tellg();
-        if (fileSize == static_cast<std::streamsize>(0))
-            return {};
-        file.seekg(0, std::ios::beg);
-        std::vector<std::uint8_t> vec(static_cast<std::size_t>(fileSize), 0);
-        file.read(reinterpret_cast<char*>(&vec[0]), fileSize);
-        return vec;
+        return content;
     };
 }
 
@@ -407,11 +831,26 @@ std::function<maybe<std::vector<std::string>>()> read_text_file_lines_maybe(
 {
     return [filename, allow_empty]() -> maybe<std::vector<std::string>>
     {
+#ifdef FPLUS_POSIX_FILE_IO
+        internal::byte_budget no_limit(0);
+        std::string content;
+        if (!internal::read_file_into(filename, false, no_limit, content))
+            return {};
+        std::vector<std::string> lines;
+        internal::for_each_line(allow_empty,
+            content.data(), content.data() + content.size(),
+            [&lines](const char* begin, const char* end)
+            {
+                lines.emplace_back(begin, end);
+            });
+        return lines;
+#else
         const auto maybe_content = read_text_file_maybe(filename)();
         if (maybe_content.is_nothing())
             return {};
         else
             return split_lines(allow_empty, maybe_content.unsafe_get_just());
+#endif
     };
 }
 
@@ -431,6 +870,533 @@ std::function<std::vector<std::string>()> read_text_file_lines(
     };
 }
 
+namespace internal
+{
+    // Reads a text file chunk by chunk through one fixed-size buffer
+    // and provides its lines one after another,
+    // using the same line-break semantics as read_text_file_lines.
+    // Memory usage only depends on the buffer size and the longest line.
+    // A read error is not taken for the end of the file,
+    // but reported by throwing an std::ios_base::failure.
+    class text_file_line_reader
+    {
+    public:
+        text_file_line_reader(const std::string& filename, bool allow_empty,
+                std::size_t buffer_size) :
+            file_(filename, std::ios::binary),
+            allow_empty_(allow_empty),
+            buffer_(std::max<std::size_t>(buffer_size, 1)),
+            pos_(0),
+            filled_(0),
+            skip_line_feed_(false),
+            is_done_(false),
+            line_()
+        {
+        }
+        text_file_line_reader(const text_file_line_reader&) = delete;
+        text_file_line_reader& operator=(const text_file_line_reader&) = delete;
+        bool is_open() const { return file_.is_open(); }
+        const std::string& line() const { return line_; }
+        // Returns false if there are no more lines.
+        bool next()
+        {
+            line_.clear();
+            while (!is_done_)
+            {
+                if (pos_ == filled_ && !refill())
+                {
+                    // The last segment, i.e. the one after the last break.
+                    is_done_ = true;
+                    return allow_empty_ || !line_.empty();
+                }
+                if (skip_line_feed_)
+                {
+                    skip_line_feed_ = false;
+                    if (buffer_[pos_] == '\n')
+                    {
+                        ++pos_;
+                        continue;
+                    }
+                }
+                const char* const begin = &buffer_[pos_];
+                const char* const end = &buffer_[0] + filled_;
+                const char* const stop = std::find_if(begin, end, [](char c)
+                {
+                    return c == '\n' || c == '\r';
+                });
+                line_.append(begin, stop);
+                pos_ += static_cast<std::size_t>(stop - begin);
+                if (stop == end)
+                    continue;
+                ++pos_;
+                skip_line_feed_ = *stop == '\r';
+                if (allow_empty_ || !line_.empty())
+                    return true;
+            }
+            return false;
+        }
+    private:
+        bool refill()
+        {
+            if (!file_.good())
+                return false;
+            file_.read(&buffer_[0],
+                static_cast<std::streamsize>(buffer_.size()));
+            if (file_.bad())
+            {
+                throw std::ios_base::failure(
+                    "text_file_lines: error reading the file");
+            }
+            pos_ = 0;
+            filled_ = static_cast<std::size_t>(file_.gcount());
+            return filled_ != 0;
+        }
+        std::ifstream file_;
+        const bool allow_empty_;
+        std::vector<char> buffer_;
+        std::size_t pos_;
+        std::size_t filled_;
+        bool skip_line_feed_;
+        bool is_done_;
+        std::string line_;
+    };
+} // namespace internal
+
+// Single-pass input range over the lines of a text file,
+// reading the file lazily through a fixed-size buffer.
+// Dereferencing an iterator yields the current line
+// as a const std::string&, whose memory is reused for the next line,
+// so processing starts immediately and runs in constant memory.
+// Copies of a range share the same reading position.
+// It can be consumed by range-based for loops, std algorithms
+// and fplus functions that only iterate once,
+// e.g., transform, keep_if, fold_left, sum, all_by or any_by,
+// the ones producing a sequence returning a std::vector.
+// If the file can not be read any further, e.g. because of an I/O error,
+// begin() or advancing an iterator throws an std::ios_base::failure
+// instead of ending the range early.
+class text_file_lines
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef std::string value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::string* pointer;
+        typedef const std::string& reference;
+        iterator() : reader_() {}
+        explicit iterator(
+                std::shared_ptr<internal::text_file_line_reader> reader) :
+            reader_(std::move(reader))
+        {
+        }
+        reference operator*() const { return reader_->line(); }
+        pointer operator->() const { return &reader_->line(); }
+        iterator& operator++()
+        {
+            if (!reader_->next())
+                reader_.reset();
+            return *this;
+        }
+        // Post-increment is only provided to fulfil the iterator concept.
+        // As with all input iterators, the returned copy is invalidated.
+        iterator operator++(int)
+        {
+            iterator result = *this;
+            ++*this;
+            return result;
+        }
+        bool operator==(const iterator& other) const
+        {
+            return reader_ == other.reader_;
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+    private:
+        std::shared_ptr<internal::text_file_line_reader> reader_;
+    };
+    typedef iterator const_iterator;
+    typedef std::string value_type;
+    text_file_lines() : reader_(), is_started_(std::make_shared<bool>(false))
+    {
+    }
+    explicit text_file_lines(
+            std::shared_ptr<internal::text_file_line_reader> reader) :
+        reader_(std::move(reader)),
+        is_started_(std::make_shared<bool>(false))
+    {
+    }
+    // Reads the first line. Must only be called once per file.
+    iterator begin() const
+    {
+        assert(!*is_started_);
+        *is_started_ = true;
+        if (!reader_ || !reader_->next())
+            return iterator();
+        return iterator(reader_);
+    }
+    iterator end() const { return iterator(); }
+private:
+    std::shared_ptr<internal::text_file_line_reader> reader_;
+    std::shared_ptr<bool> is_started_;
+};
+
+namespace internal
+{
+    template <>
+    struct has_order<text_file_lines> : public std::true_type {};
+
+    // Element-wise results (e.g. of transform or keep_if)
+    // are stored in a std::vector.
+    template <typename NewT, int SizeOffset>
+    struct same_cont_new_t<text_file_lines, NewT, SizeOffset>
+    {
+        typedef typename std::vector<NewT> type;
+    };
+
+    template <>
+    struct can_reuse<text_file_lines>
+    {
+        using value = create_new_container_t;
+    };
+
+    template <>
+    struct materialized<text_file_lines>
+    {
+        typedef std::vector<std::string> type;
+    };
+} // namespace internal
+
+// API search type: read_text_file_lines_lazy_maybe : (Bool, String, Int) -> Io (Maybe TextFileLines)
+// Returns a function that (when called) opens a text file
+// and provides its lines as a lazy single-pass range.
+// In contrast to read_text_file_lines the file is read
+// only while the range is being iterated,
+// using a reusable buffer of buffer_size bytes.
+// Yields the same lines as read_text_file_lines.
+inline
+std::function<maybe<text_file_lines>()> read_text_file_lines_lazy_maybe(
+        bool allow_empty, const std::string& filename,
+        std::size_t buffer_size = 1 << 16)
+{
+    return [allow_empty, filename, buffer_size]() -> maybe<text_file_lines>
+    {
+        auto reader = std::make_shared<internal::text_file_line_reader>(
+            filename, allow_empty, buffer_size);
+        if (!reader->is_open())
+            return {};
+        return text_file_lines(std::move(reader));
+    };
+}
+
+// API search type: read_text_file_lines_lazy : (Bool, String, Int) -> Io TextFileLines
+// Returns a function that (when called) opens a text file
+// and provides its lines as a lazy single-pass range.
+// This function then returns an empty range if the file could not be read.
+inline
+std::function<text_file_lines()> read_text_file_lines_lazy(
+        bool allow_empty, const std::string& filename,
+        std::size_t buffer_size = 1 << 16)
+{
+    return [allow_empty, filename, buffer_size]() -> text_file_lines
+    {
+        return just_with_default(text_file_lines(),
+            read_text_file_lines_lazy_maybe(
+                allow_empty, filename, buffer_size)());
+    };
+}
+
+namespace internal
+{
+    template <typename Container, typename ContainerIn>
+    std::vector<maybe<Container>> read_files(bool binary,
+        std::size_t n_threads, std::size_t max_bytes_in_flight,
+        const ContainerIn& filenames)
+    {
+        const std::vector<std::string> names(
+            std::begin(filenames), std::end(filenames));
+        std::vector<Container> contents(names.size());
+        // Not std::vector<bool>, since the threads write concurrently.
+        std::vector<unsigned char> successes(names.size(), 0);
+        byte_budget budget(max_bytes_in_flight);
+        std::atomic<std::size_t> next_idx(0);
+
+        const auto worker_func = [&]()
+        {
+            for (;;)
+            {
+                const std::size_t idx = next_idx++;
+                if (idx >= names.size())
+                    return;
+                successes[idx] = read_file_into(
+                    names[idx], binary, budget, contents[idx]) ? 1 : 0;
+            }
+        };
+
+        if (n_threads == 0)
+            n_threads = std::max<std::size_t>(
+                std::thread::hardware_concurrency(), 1);
+        n_threads = std::min(n_threads, names.size());
+        std::vector<std::thread> threads;
+        threads.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i)
+            threads.emplace_back(worker_func);
+        for (auto& thread : threads)
+            thread.join();
+
+        std::vector<maybe<Container>> results;
+        results.reserve(names.size());
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            // Same as read_binary_file_maybe, which returns nothing
+            // for empty files.
+            if (successes[i] && !(binary && contents[i].empty()))
+                results.emplace_back(std::move(contents[i]));
+            else
+                results.emplace_back();
+        }
+        return results;
+    }
+} // namespace internal
+
+// API search type: read_binary_files : (Int, Int, [String]) -> Io [Maybe [Int]]
+// Returns a function that (when called) reads multiple binary files
+// with a bounded pool of n_threads threads
+// (0 = std::thread::hardware_concurrency).
+// At most max_bytes_in_flight bytes are read at the same time (0 = no limit),
+// a larger file is only read when no other read is running.
+// The results are in the same order as the filenames,
+// with the same semantics as read_binary_file_maybe.
+template <typename ContainerIn>
+std::function<std::vector<maybe<std::vector<std::uint8_t>>>()>
+read_binary_files(std::size_t n_threads, std::size_t max_bytes_in_flight,
+    const ContainerIn& filenames)
+{
+    return [n_threads, max_bytes_in_flight, filenames]()
+        -> std::vector<maybe<std::vector<std::uint8_t>>>
+    {
+        return internal::read_files<std::vector<std::uint8_t>>(
+            true, n_threads, max_bytes_in_flight, filenames);
+    };
+}
+
+// API search type: read_text_files : (Int, Int, [String]) -> Io [Maybe String]
+// Returns a function that (when called) reads multiple text files
+// with a bounded pool of n_threads threads
+// (0 = std::thread::hardware_concurrency).
+// At most max_bytes_in_flight bytes are read at the same time (0 = no limit),
+// a larger file is only read when no other read is running.
+// The results are in the same order as the filenames,
+// with the same semantics as read_text_file_maybe.
+template <typename ContainerIn>
+std::function<std::vector<maybe<std::string>>()>
+read_text_files(std::size_t n_threads, std::size_t max_bytes_in_flight,
+    const ContainerIn& filenames)
+{
+    return [n_threads, max_bytes_in_flight, filenames]()
+        -> std::vector<maybe<std::string>>
+    {
+        return internal::read_files<std::string>(
+            false, n_threads, max_bytes_in_flight, filenames);
+    };
+}
+
+// Settings for the buffered file writers.
+// buffer_size: Number of bytes collected before they are written
+//     when writing lines. A single content is written directly.
+// preallocate: Reserve the disk space for the whole content up front
+//     (posix_fallocate on Linux), which reduces fragmentation.
+// sync: Make sure the data reached the storage device before returning
+//     (fdatasync on Linux, fsync on other POSIX systems).
+struct file_write_options
+{
+    std::size_t buffer_size = 1 << 20;
+    bool preallocate = false;
+    bool sync = false;
+};
+
+namespace internal
+{
+    // Writes to a file through one reusable buffer,
+    // which is only allocated once a piece smaller than it is written.
+    // Pieces not fitting into the buffer are written directly
+    // together with the buffered data using one writev call (POSIX),
+    // so large elements are never copied.
+    // With a buffer_size of 0 everything is written directly.
+    class file_writer
+    {
+    public:
+        file_writer(const std::string& filename, bool binary,
+                std::size_t buffer_size) :
+#ifdef FPLUS_POSIX_FILE_IO
+            fd_(::open(filename.c_str(),
+                O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)),
+            is_good_(fd_ >= 0),
+#else
+            file_(),
+            is_good_(false),
+#endif
+            buffer_size_(buffer_size),
+            buffer_(),
+            used_(0)
+        {
+#ifdef FPLUS_POSIX_FILE_IO
+            (void)binary;
+#else
+            file_.open(filename, binary
+                ? std::ios::out | std::ios::binary
+                : std::ios::out);
+            is_good_ = file_.good();
+#endif
+        }
+        ~file_writer()
+        {
+#ifdef FPLUS_POSIX_FILE_IO
+            if (fd_ >= 0)
+                ::close(fd_);
+#endif
+        }
+        file_writer(const file_writer&) = delete;
+        file_writer& operator=(const file_writer&) = delete;
+        bool is_good() const { return is_good_; }
+        void preallocate(std::size_t size)
+        {
+#if defined(FPLUS_POSIX_FILE_IO) && defined(__linux__)
+            // Only a hint, failure (e.g. unsupported) is not an error.
+            if (is_good_ && size > 0)
+                ::posix_fallocate(fd_, 0, static_cast<::off_t>(size));
+#else
+            (void)size;
+#endif
+        }
+        void write(const char* data, std::size_t size)
+        {
+            if (size == 0)
+                return;
+            if (size >= buffer_size_)
+            {
+                write_buffer_and(data, size);
+                return;
+            }
+            if (!buffer_)
+                buffer_.reset(new char[buffer_size_]);
+            if (size > buffer_size_ - used_)
+                write_buffer_and(nullptr, 0);
+            std::memcpy(buffer_.get() + used_, data, size);
+            used_ += size;
+        }
+        // Writes the remaining data and closes the file.
+        // Returns true if everything was written successfully.
+        bool finish(bool sync)
+        {
+            write_buffer_and(nullptr, 0);
+#ifdef FPLUS_POSIX_FILE_IO
+            if (is_good_ && sync)
+            {
+#ifdef __linux__
+                is_good_ = ::fdatasync(fd_) == 0;
+#else
+                is_good_ = ::fsync(fd_) == 0;
+#endif
+            }
+            if (fd_ >= 0)
+            {
+                is_good_ = ::close(fd_) == 0 && is_good_;
+                fd_ = -1;
+            }
+#else
+            (void)sync;
+            file_.close();
+            is_good_ = is_good_ && !file_.fail();
+#endif
+            return is_good_;
+        }
+    private:
+        void write_buffer_and(const char* data, std::size_t size)
+        {
+            if (used_ == 0 && size == 0)
+                return;
+#ifdef FPLUS_POSIX_FILE_IO
+            ::iovec segments[2] = {
+                {buffer_.get(), used_},
+                {const_cast<char*>(data), size}};
+            ::iovec* first =
+                segments[0].iov_len == 0 ? segments + 1 : segments;
+            ::iovec* const last = segments + 2;
+            while (is_good_ && first != last)
+            {
+                const ::ssize_t count = ::writev(
+                    fd_, first, static_cast<int>(last - first));
+                if (count < 0)
+                {
+                    is_good_ = errno == EINTR;
+                    continue;
+                }
+                std::size_t written = static_cast<std::size_t>(count);
+                while (first != last && written >= first->iov_len)
+                {
+                    written -= first->iov_len;
+                    ++first;
+                }
+                if (first != last)
+                {
+                    first->iov_base = static_cast<char*>(first->iov_base) +
+                        written;
+                    first->iov_len -= written;
+                }
+            }
+#else
+            if (used_ > 0)
+                file_.write(buffer_.get(), static_cast<std::streamsize>(used_));
+            if (size > 0)
+                file_.write(data, static_cast<std::streamsize>(size));
+            is_good_ = is_good_ && file_.good();
+#endif
+            used_ = 0;
+        }
+#ifdef FPLUS_POSIX_FILE_IO
+        int fd_;
+#else
+        std::ofstream file_;
+#endif
+        bool is_good_;
+        std::size_t buffer_size_;
+        std::unique_ptr<char[]> buffer_;
+        std::size_t used_;
+    };
+
+    inline bool write_file(const file_write_options& options, bool binary,
+        const std::string& filename, const char* data, std::size_t size)
+    {
+        // The content is already contiguous, so it is not buffered.
+        internal::file_writer writer(filename, binary, 0);
+        if (options.preallocate)
+            writer.preallocate(size);
+        writer.write(data, size);
+        return writer.finish(options.sync);
+    }
+} // namespace internal
+
+// API search type: write_text_file_with_options : (FileWriteOptions, String, String) -> Io Bool
+// Returns a function that (when called) writes content into a text file,
+// replacing it if it already exists.
+inline
+std::function<bool()> write_text_file_with_options(
+        const file_write_options& options,
+        const std::string& filename,
+        const std::string& content)
+{
+    return [options, filename, content]() -> bool
+    {
+        return internal::write_file(options, false, filename,
+            content.data(), content.size());
+    };
+}
+
 // API search type: write_text_file : (String, String) -> Io Bool
 // Returns a function that (when called) writes content into a text file,
 // replacing it if it already exists.
@@ -438,11 +1404,23 @@ inline
 std::function<bool()> write_text_file(const std::string& filename,
         const std::string& content)
 {
-    return [filename, content]() -> bool
+    return write_text_file_with_options(
+        file_write_options(), filename, content);
+}
+
+// API search type: write_binary_file_with_options : (FileWriteOptions, String, [Int]) -> Io Bool
+// Returns a function that (when called) writes content into a binary file,
+// replacing it if it already exists.
+inline
+std::function<bool()> write_binary_file_with_options(
+        const file_write_options& options,
+        const std::string& filename,
+        const std::vector<uint8_t>& content)
+{
+    return [options, filename, content]() -> bool
     {
-        std::ofstream output(filename);
-        output << content;
-        return output.good();
+        return internal::write_file(options, true, filename,
+            reinterpret_cast<const char*>(content.data()), content.size());
     };
 }
 
@@ -453,12 +1431,45 @@ inline
 std::function<bool()> write_binary_file(const std::string& filename,
         const std::vector<uint8_t>& content)
 {
-    return [filename, content]() -> bool
+    return write_binary_file_with_options(
+        file_write_options(), filename, content);
+}
+
+// API search type: write_text_file_lines_with_options : (FileWriteOptions, Bool, String, [String]) -> Io Bool
+// Returns a function that (when called) writes lines into a text file,
+// replacing it if it already exists.
+// The lines are streamed into the file one by one,
+// so the whole content is never joined into one string.
+// Lines passed as an rvalue are moved into the effect instead of copied.
+template <typename ContainerIn>
+std::function<bool()> write_text_file_lines_with_options(
+        const file_write_options& options,
+        bool trailing_newline,
+        const std::string& filename,
+        ContainerIn&& lines)
+{
+    return [options, trailing_newline, filename,
+        lines = std::forward<ContainerIn>(lines)]() -> bool
     {
-        std::ofstream file(filename, std::ios::binary);
-        file.write(reinterpret_cast<const char*>(&content[0]),
-            static_cast<std::streamsize>(content.size()));
-        return file.good();
+        internal::file_writer writer(filename, false, options.buffer_size);
+        if (options.preallocate && !lines.empty())
+        {
+            std::size_t size = trailing_newline ? 1 : 0;
+            for (const auto& line : lines)
+                size += line.size() + 1;
+            writer.preallocate(size - 1);
+        }
+        bool is_first = true;
+        for (const auto& line : lines)
+        {
+            if (!is_first)
+                writer.write("\n", 1);
+            is_first = false;
+            writer.write(line.data(), line.size());
+        }
+        if (trailing_newline)
+            writer.write("\n", 1);
+        return writer.finish(options.sync);
     };
 }
 
@@ -470,12 +1481,17 @@ std::function<bool()> write_text_file_lines(bool trailing_newline,
         const std::string& filename,
         const std::vector<std::string>& lines)
 {
-    std::string content = join(std::string("\n"), lines);
-    if (trailing_newline)
-    {
-        content += "\n";
-    }
-    return write_text_file(filename, content);
+    return write_text_file_lines_with_options(
+        file_write_options(), trailing_newline, filename, lines);
+}
+
+inline
+std::function<bool()> write_text_file_lines(bool trailing_newline,
+        const std::string& filename,
+        std::vector<std::string>&& lines)
+{
+    return write_text_file_lines_with_options(
+        file_write_options(), trailing_newline, filename, std::move(lines));
 }
 
 // API search type: execute_effect : Io a -> a
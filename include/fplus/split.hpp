@@ -692,6 +692,22 @@ ContainerOut aperture(std::size_t length, const ContainerIn& xs)
     return result;
 }
 
+// API search type: aperture_lazy : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Lazy version of aperture, see infixes_lazy.
+// The windows are views into xs, so xs has to outlive the result.
+// Useful for rolling computations on long sequences:
+// transform(fwd::sum(), aperture_lazy(64, xs))
+// aperture_lazy(5, [0,1,2,3,4,5,6]) == [[0,1,2,3,4],[1,2,3,4,5],[2,3,4,5,6]]
+template <typename Container>
+auto aperture_lazy(std::size_t length, const Container& xs)
+{
+    return infixes_lazy(length, xs);
+}
+
+template <typename Container>
+void aperture_lazy(std::size_t, const Container&&) = delete;
+
 // API search type: stride : (Int, [a]) -> [a]
 // fwd bind count: 1
 // Keeps every nth element.
@@ -715,43 +731,69 @@ Container stride(std::size_t step, const Container& xs)
     return ys;
 }
 
+namespace internal
+{
+    template <typename Container, typename Buffer>
+    Container from_selection_buffer(std::true_type, Buffer&& ys)
+    {
+        return std::forward<Buffer>(ys);
+    }
+
+    template <typename Container, typename Buffer>
+    Container from_selection_buffer(std::false_type, const Buffer& ys)
+    {
+        return convert_container<Container>(ys);
+    }
+} // namespace internal
+
 // API search type: winsorize : (Float, [Float]) -> [Float]
 // fwd bind count: 1
 // Winsorizing
 // winsorize(0.1, [1,3,4,4,4,4,4,4,6,8]) == [3,3,4,4,4,4,4,4,6,6]
-template <typename Container>
-Container winsorize(double trim_ratio, const Container& xs)
+// The result is sorted.
+// The clipping bounds are found using selection,
+// so only the values between them need to be sorted.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut winsorize(double trim_ratio, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("winsorize", Container, xs);
     if (size_of_cont(xs) < 2)
     {
-        return xs;
+        return std::forward<Container>(xs);
     }
     trim_ratio = std::max(trim_ratio, 0.0);
-    const auto xs_sorted = sort(xs);
+    const std::size_t size = size_of_cont(xs);
     std::size_t amount =
         floor<double, std::size_t>(
-            trim_ratio * static_cast<double>(size_of_cont(xs_sorted)));
-    amount = std::min(size_of_cont(xs_sorted) / 2, amount);
-    const auto parts = split_at_idxs(
-        std::vector<std::size_t>({amount, size_of_cont(xs_sorted) - amount}),
-        xs_sorted);
-    assert(size_of_cont(parts) == 3);
-    typedef typename Container::value_type T;
-    if (is_empty(parts[1]))
+            trim_ratio * static_cast<double>(size));
+    amount = std::min(size / 2, amount);
+    auto ys = internal::make_selection_buffer(std::forward<Container>(xs));
+    typedef decltype(ys) Buffer;
+    const auto first = std::begin(ys);
+    const auto last = std::end(ys);
+    if (size == 2 * amount)
     {
-        return Container(size_of_cont(xs_sorted), median(xs_sorted));
+        const auto x_median =
+            internal::median_of_range<typename ContainerOut::value_type>(
+                first, last);
+        std::fill(first, last, x_median);
     }
     else
     {
-        const T lower = parts[1].front();
-        const T upper = parts[1].back();
-        const auto result = concat(std::vector<Container>({
-            Container(amount, lower),
-            parts[1],
-            Container(amount, upper)}));
-        assert(size_of_cont(result) == size_of_cont(xs_sorted));
-        return result;
+        const auto mid_first = first + static_cast<std::ptrdiff_t>(amount);
+        const auto mid_last = last - static_cast<std::ptrdiff_t>(amount);
+        if (amount != 0)
+        {
+            std::nth_element(first, mid_first, last);
+            std::nth_element(mid_first, mid_last - 1, last);
+        }
+        std::sort(mid_first, mid_last);
+        std::fill(first, mid_first, *mid_first);
+        std::fill(mid_last, last, *(mid_last - 1));
     }
+    return internal::from_selection_buffer<ContainerOut>(
+        std::is_same<ContainerOut, Buffer>(), std::move(ys));
 }
 
 } // namespace fplus
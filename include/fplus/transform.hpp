@@ -28,16 +28,25 @@
 namespace fplus
 {
 
-// API search type: transform_with_idx : (((Int, a) -> b), [a]) -> [b]
-// fwd bind count: 1
-// Apply a function to every index and corresponding element of a sequence.
-// transform_with_idx(f, [6, 4, 7]) == [f(0, 6), f(1, 4), f(2, 7)]
-template <typename F, typename ContainerIn,
-    typename ContainerOut = typename internal::same_cont_new_t_from_binary_f<
-        ContainerIn, F, std::size_t, typename ContainerIn::value_type, 0>::type>
-ContainerOut transform_with_idx(F f, const ContainerIn& xs)
+namespace internal
+{
+
+template <typename ContainerOut, typename F, typename Container>
+ContainerOut transform_with_idx(internal::reuse_container_t,
+    F f, Container&& xs)
+{
+    std::size_t idx = 0;
+    for (auto& x : xs)
+    {
+        x = f(idx++, x);
+    }
+    return std::forward<Container>(xs);
+}
+
+template <typename ContainerOut, typename F, typename ContainerIn>
+ContainerOut transform_with_idx(internal::create_new_container_t,
+    F f, const ContainerIn& xs)
 {
-    internal::check_arity<2, F>();
     ContainerOut ys;
     internal::prepare_container(ys, size_of_cont(xs));
     auto it = internal::get_back_inserter<ContainerOut>(ys);
@@ -49,13 +58,92 @@ ContainerOut transform_with_idx(F f, const ContainerIn& xs)
     return ys;
 }
 
+} // namespace internal
+
+// API search type: transform_with_idx : (((Int, a) -> b), [a]) -> [b]
+// fwd bind count: 1
+// Apply a function to every index and corresponding element of a sequence.
+// transform_with_idx(f, [6, 4, 7]) == [f(0, 6), f(1, 4), f(2, 7)]
+template <typename F, typename ContainerIn,
+    typename ContainerOut = typename internal::same_cont_new_t_from_binary_f<
+        internal::remove_const_and_ref_t<ContainerIn>, F, std::size_t,
+        typename internal::remove_const_and_ref_t<ContainerIn>::value_type,
+        0>::type>
+ContainerOut transform_with_idx(F f, ContainerIn&& xs)
+{
+    FPLUS_INSTRUMENT_CALL("transform_with_idx", ContainerIn, xs);
+    internal::check_arity<2, F>();
+    using reuse_t = typename std::conditional<
+        std::is_same<
+            internal::can_reuse_v<ContainerIn>,
+            internal::reuse_container_t>::value &&
+        std::is_base_of<
+            std::true_type,
+            internal::has_order<ContainerIn>>::value &&
+        std::is_same<
+            internal::remove_const_and_ref_t<ContainerIn>,
+            ContainerOut>::value,
+        internal::reuse_container_t,
+        internal::create_new_container_t>::type;
+    return internal::transform_with_idx<ContainerOut>(
+        reuse_t{}, f, std::forward<ContainerIn>(xs));
+}
+
+namespace internal
+{
+
+// Payload accessors that move out of temporaries
+// and copy out of everything else.
+template <typename T>
+const T& forward_just(const maybe<T>& m)
+{
+    return m.unsafe_get_just();
+}
+
+template <typename T>
+T&& forward_just(maybe<T>&& m)
+{
+    return std::move(m.unsafe_get_just());
+}
+
+template <typename Ok, typename Error>
+const Ok& forward_ok(const result<Ok, Error>& r)
+{
+    return r.unsafe_get_ok();
+}
+
+template <typename Ok, typename Error>
+Ok&& forward_ok(result<Ok, Error>&& r)
+{
+    return std::move(r.unsafe_get_ok());
+}
+
+template <typename ContainerOut, typename Container>
+void append_elems(ContainerOut& ys, const Container& xs)
+{
+    ys.insert(std::end(ys), std::begin(xs), std::end(xs));
+}
+
+template <typename ContainerOut, typename Container,
+    typename = std::enable_if_t<!std::is_lvalue_reference<Container>::value>>
+void append_elems(ContainerOut& ys, Container&& xs)
+{
+    ys.insert(std::end(ys),
+        std::make_move_iterator(std::begin(xs)),
+        std::make_move_iterator(std::end(xs)));
+}
+
+} // namespace internal
+
 // API search type: transform_and_keep_justs : ((a -> Maybe b), [a]) -> [b]
 // fwd bind count: 1
 // Map function over values and drop resulting nothings.
 // Also known as filter_map.
+// Runs in a single pass without an intermediate container of maybes.
 template <typename F, typename ContainerIn>
 auto transform_and_keep_justs(F f, const ContainerIn& xs)
 {
+    FPLUS_INSTRUMENT_CALL("transform_and_keep_justs", const ContainerIn&, xs);
     using X = typename ContainerIn::value_type;
     (void)detail::
         trigger_static_asserts<detail::transform_and_keep_justs_tag, F, X>();
@@ -64,16 +152,27 @@ auto transform_and_keep_justs(F f, const ContainerIn& xs)
         ContainerIn,
         typename std::decay_t<detail::invoke_result_t<F, X>>::type>::type;
 
-    auto transformed = transform(f, xs);
-    return justs<decltype(transformed), ContainerOut>(transformed);
+    ContainerOut ys;
+    auto it = internal::get_back_inserter<ContainerOut>(ys);
+    for (const auto& x : xs)
+    {
+        auto&& y = detail::invoke(f, x);
+        if (y.is_just())
+        {
+            *it = internal::forward_just(std::forward<decltype(y)>(y));
+        }
+    }
+    return ys;
 }
 
 // API search type: transform_and_keep_oks : ((a -> Result b), [a]) -> [b]
 // fwd bind count: 1
 // Map function over values and drop resulting errors.
+// Runs in a single pass without an intermediate container of results.
 template <typename F, typename ContainerIn>
 auto transform_and_keep_oks(F f, const ContainerIn& xs)
 {
+    FPLUS_INSTRUMENT_CALL("transform_and_keep_oks", const ContainerIn&, xs);
     using X = typename ContainerIn::value_type;
     (void)detail::
         trigger_static_asserts<detail::transform_and_keep_oks_tag, F, X>();
@@ -81,32 +180,76 @@ auto transform_and_keep_oks(F f, const ContainerIn& xs)
     using ContainerOut = typename internal::same_cont_new_t<
         ContainerIn,
         typename std::decay_t<detail::invoke_result_t<F, X>>::ok_t>::type;
-    auto transformed = transform(f, xs);
-    return oks<decltype(transformed), ContainerOut>(transformed);
+
+    ContainerOut ys;
+    auto it = internal::get_back_inserter<ContainerOut>(ys);
+    for (const auto& x : xs)
+    {
+        auto&& y = detail::invoke(f, x);
+        if (y.is_ok())
+        {
+            *it = internal::forward_ok(std::forward<decltype(y)>(y));
+        }
+    }
+    return ys;
 }
 
 // API search type: transform_and_concat : ((a -> [b]), [a]) -> [b]
 // fwd bind count: 1
 // Map function over values and concat results.
 // Also known as flat_map or concat_map.
+// Every result is appended to the output (moved if it is a temporary)
+// as soon as it is produced.
 template <typename F, typename ContainerIn,
     typename ContainerOut = typename internal::same_cont_new_t_from_unary_f<
         ContainerIn, F>::type::value_type>
 ContainerOut transform_and_concat(F f, const ContainerIn& xs)
 {
+    FPLUS_INSTRUMENT_CALL("transform_and_concat", const ContainerIn&, xs);
     internal::check_arity<1, F>();
-    return concat(transform(f, xs));
+    ContainerOut ys;
+    for (const auto& x : xs)
+    {
+        auto&& y = detail::invoke(f, x);
+        internal::append_elems(ys, std::forward<decltype(y)>(y));
+    }
+    return ys;
+}
+
+namespace internal
+{
+
+template <typename Reuse, typename Container,
+    typename ContainerOut = remove_const_and_ref_t<Container>>
+ContainerOut replicate_elems(Reuse reuse, std::size_t n, Container&& xs)
+{
+    ContainerOut ys;
+    if (n == 0)
+        return ys;
+    internal::prepare_container(ys, n * size_of_cont(xs));
+    auto it = internal::get_back_inserter<ContainerOut>(ys);
+    for (auto& x : xs)
+    {
+        for (std::size_t i = 1; i < n; ++i)
+            *it = x;
+        *it = internal::forward_elem(reuse, x);
+    }
+    return ys;
 }
 
+} // namespace internal
+
 // API search type: replicate_elems : (Int, [a]) -> [a]
 // fwd bind count: 1
 // Replicate every element n times, concatenate the result.
 // replicate_elems(3, [1,2]) == [1, 1, 1, 2, 2, 2]
-template <typename Container>
-Container replicate_elems(std::size_t n, const Container& xs)
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut replicate_elems(std::size_t n, Container&& xs)
 {
-    typedef typename Container::value_type T;
-    return transform_and_concat(bind_1st_of_2(replicate<T, Container>, n), xs);
+    FPLUS_INSTRUMENT_CALL("replicate_elems", Container, xs);
+    return internal::replicate_elems(internal::can_reuse_v<Container>{},
+        n, std::forward<Container>(xs));
 }
 
 // API search type: interleave : [[a]] -> [a]
@@ -195,6 +338,7 @@ template <typename Container,
     typename ContainerOut = internal::remove_const_and_ref_t<Container>>
 ContainerOut shuffle(std::uint_fast32_t seed, Container&& xs)
 {
+    FPLUS_INSTRUMENT_CALL("shuffle", Container, xs);
     return(internal::shuffle(internal::can_reuse_v<Container>{},
         seed, std::forward<Container>(xs)));
 }
@@ -305,6 +449,7 @@ auto apply_function_n_times(F f, std::size_t n, const FIn& x)
 template <typename F, typename ContainerIn>
 auto transform_parallelly(F f, const ContainerIn& xs)
 {
+    FPLUS_INSTRUMENT_CALL("transform_parallelly", const ContainerIn&, xs);
     using ContainerOut = typename internal::
         same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
     using X = typename ContainerIn::value_type;
@@ -395,6 +540,59 @@ typename Container::value_type reduce_1_parallelly(F f, const Container& xs)
     }
 }
 
+namespace internal
+{
+    template <typename Acc, typename It>
+    moments<Acc> moments_parallelly(std::size_t size, It it)
+    {
+        typedef typename std::iterator_traits<It>::value_type T;
+        typedef std::integral_constant<bool,
+            std::is_pointer<It>::value &&
+            std::is_arithmetic<T>::value> is_contiguous;
+        const auto partial_moments = transform_chunks_parallelly(1 << 16,
+            size, it, [](It chunk_begin, It chunk_end)
+            {
+                return moments_of_range<Acc>(
+                    is_contiguous(), chunk_begin, chunk_end);
+            });
+        moments<Acc> result = {0, Acc(0), Acc(0)};
+        for (const auto& partial : partial_moments)
+        {
+            result.merge(partial);
+        }
+        return result;
+    }
+
+    template <typename Acc, typename Container>
+    moments<Acc> moments_parallelly(std::true_type, const Container& xs)
+    {
+        return moments_parallelly<Acc>(size_of_cont(xs), xs.data());
+    }
+
+    template <typename Acc, typename Container>
+    moments<Acc> moments_parallelly(std::false_type, const Container& xs)
+    {
+        return moments_parallelly<Acc>(size_of_cont(xs), std::begin(xs));
+    }
+} // namespace internal
+
+// API search type: mean_stddev_parallelly : [a] -> (a, a)
+// fwd bind count: 0
+// mean_stddev_parallelly([4, 8]) == (6, 2)
+// Same as mean_stddev, but can utilize multiple CPUs by using std::async.
+// Every thread calculates the moments of one chunk of the sequence,
+// and the partial results are merged in a numerically stable way.
+// xs must be non-empty.
+template <typename Result, typename Container>
+std::pair<Result, Result> mean_stddev_parallelly(const Container& xs)
+{
+    assert(size_of_cont(xs) != 0);
+    typedef internal::moments_acc_t<Result> Acc;
+    return internal::mean_stddev_from_moments<Result>(
+        internal::moments_parallelly<Acc>(
+            internal::is_contiguous_arithmetic<Container>(), xs));
+}
+
 // API search type: keep_if_parallelly : ((a -> Bool), [a]) -> [a]
 // fwd bind count: 1
 // Same as keep_if but using multiple threads.
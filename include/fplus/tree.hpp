@@ -6,8 +6,13 @@
 
 #pragma once
 
-#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <map>
 #include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace fplus
 {
@@ -15,8 +20,57 @@ namespace fplus
 template <typename T>
 struct tree
 {
-    tree (const T& value, const std::vector<tree<T>>& children) :
-        value_(value), children_(children) {}
+    tree (T value, std::vector<tree<T>> children) :
+        value_(std::move(value)), children_(std::move(children)) {}
+    // Copies the descendants level by level using an explicit stack,
+    // so deep trees do not overflow the call stack.
+    tree(const tree& other) : value_(other.value_), children_()
+    {
+        std::vector<std::pair<const tree<T>*, tree<T>*>> stack(
+            1, std::make_pair(&other, this));
+        while (!stack.empty())
+        {
+            const tree<T>& src = *stack.back().first;
+            tree<T>& dst = *stack.back().second;
+            stack.pop_back();
+            dst.children_.reserve(src.children_.size());
+            for (const auto& child : src.children_)
+            {
+                dst.children_.emplace_back(child.value_,
+                    std::vector<tree<T>>());
+            }
+            for (std::size_t i = 0; i < src.children_.size(); ++i)
+            {
+                stack.push_back(
+                    std::make_pair(&src.children_[i], &dst.children_[i]));
+            }
+        }
+    }
+    tree(tree&&) = default;
+    tree& operator=(const tree& other)
+    {
+        if (this != &other)
+            *this = tree(other);
+        return *this;
+    }
+    tree& operator=(tree&&) = default;
+    // Tears the descendants down one by one using an explicit stack,
+    // so deep trees do not overflow the call stack.
+    ~tree()
+    {
+        if (children_.empty())
+            return;
+        std::vector<tree<T>> stack = std::move(children_);
+        while (!stack.empty())
+        {
+            std::vector<tree<T>> children = std::move(stack.back().children_);
+            stack.pop_back();
+            for (auto& child : children)
+            {
+                stack.push_back(std::move(child));
+            }
+        }
+    }
     T value_;
     std::vector<tree<T>> children_;
 };
@@ -33,44 +87,77 @@ tree<T> make_singleton_tree(const T& x)
 namespace internal
 {
 
+// Orders the trees such that every tree comes after all trees
+// that are children of it, by peeling off the trees without children
+// round by round. Each round keeps the order of the input.
+// Trees that are part of a cycle are appended at the end.
+// O(n^2) calls of tree_is_child_of.
 template <typename BinaryPredicate, typename T>
 std::vector<tree<T>> presort_trees(BinaryPredicate tree_is_child_of,
-    std::vector<tree<T>> xs_orig)
+    std::vector<tree<T>> xs)
 {
-    auto xs = fplus::convert_container<std::list<tree<T>>>(xs_orig);
-    std::vector<tree<T>> result;
-    while (!xs.empty())
+    const std::size_t n = xs.size();
+    std::vector<std::size_t> children_left(n, 0);
+    for (std::size_t i = 0; i < n; ++i)
     {
-        for (auto it = std::begin(xs); it != std::end(xs);)
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            if (i != j && tree_is_child_of(xs[j], xs[i]))
+                ++children_left[i];
+        }
+    }
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    std::vector<bool> done(n, false);
+    std::vector<std::size_t> round;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (children_left[i] == 0)
+            round.push_back(i);
+    }
+    while (!round.empty())
+    {
+        std::sort(std::begin(round), std::end(round));
+        std::vector<std::size_t> next_round;
+        for (std::size_t i : round)
+        {
+            done[i] = true;
+            order.push_back(i);
+        }
+        for (std::size_t i : round)
         {
-            bool has_children = false;
-            for (auto it_rest = std::begin(xs); it_rest != std::end(xs); ++it_rest)
+            for (std::size_t j = 0; j < n; ++j)
             {
-                if (it_rest != it && tree_is_child_of(*it_rest, *it))
+                if (!done[j] && j != i && tree_is_child_of(xs[i], xs[j]) &&
+                    --children_left[j] == 0)
                 {
-                    has_children = true;
+                    next_round.push_back(j);
                 }
             }
-            if (!has_children)
-            {
-                result.push_back(*it);
-                it = xs.erase(it);
-            }
-            else
-            {
-                ++it;
-            }
         }
+        round = std::move(next_round);
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (!done[i])
+            order.push_back(i);
+    }
+    std::vector<tree<T>> result;
+    result.reserve(n);
+    for (std::size_t i : order)
+    {
+        result.push_back(std::move(xs[i]));
     }
-    return std::move(result);
+    return result;
 }
 
+// Moves every tree into the first later tree it is a child of.
 template <typename BinaryPredicate, typename TreeCont> // todo: name?
 TreeCont trees_from_sequence_helper(
     BinaryPredicate tree_is_child_of, TreeCont xs_unsorted)
 {
     TreeCont result;
-    auto xs = presort_trees(tree_is_child_of, xs_unsorted);
+    auto xs = presort_trees(tree_is_child_of, std::move(xs_unsorted));
     for (auto it = std::begin(xs); it != std::end(xs); ++it)
     {
         const auto find_pred = bind_1st_of_2(tree_is_child_of, *it);
@@ -79,11 +166,11 @@ TreeCont trees_from_sequence_helper(
         auto parent_it = std::find_if(it_find_begin, std::end(xs), find_pred);
         if (parent_it != std::end(xs))
         {
-            parent_it->children_.push_back(*it);
+            parent_it->children_.push_back(std::move(*it));
         }
         else
         {
-            result.push_back(*it);
+            result.push_back(std::move(*it));
         }
     }
     return result;
@@ -94,6 +181,8 @@ TreeCont trees_from_sequence_helper(
 // API search type: trees_from_sequence : (((a, a) -> Bool), [a]) -> [Tree a]
 // fwd bind count: 1
 // Converts the sequence into a tree considering the given binary predicate.
+// O(n^2) calls of is_child_of.
+// If the elements have keys, trees_from_sequence_by_keys is much faster.
 template <typename BinaryPredicate, typename Container> // todo: name?
 std::vector<tree<typename Container::value_type>> trees_from_sequence(
     BinaryPredicate is_child_of, const Container& xs)
@@ -101,7 +190,7 @@ std::vector<tree<typename Container::value_type>> trees_from_sequence(
     internal::check_binary_predicate_for_container<BinaryPredicate, Container>();
     typedef typename Container::value_type T;
     typedef tree<T> Tree;
-    const auto singletons = transform_convert<std::vector<Tree>>(
+    auto singletons = transform_convert<std::vector<Tree>>(
         internal::make_singleton_tree<T>, xs);
     const auto tree_is_child_of =
         [is_child_of](const tree<T>& a, const tree<T>& b) -> bool
@@ -115,74 +204,223 @@ std::vector<tree<typename Container::value_type>> trees_from_sequence(
 namespace internal
 {
 
-// -1 = a < b
-//  0 = a == b
-//  1 = b < a
-template <typename T>
-int tree_cmp(const tree<T>& a, const tree<T>& b)
+// Cuts the parent link of one element of every cycle,
+// so that following the parent links always ends at a root.
+inline void break_parent_cycles(std::vector<std::size_t>& parents)
 {
-    if(a.value_ < b.value_)
+    const std::size_t n = parents.size();
+    const std::size_t no_parent = n;
+    enum class state { unvisited, on_path, done };
+    std::vector<state> states(n, state::unvisited);
+    std::vector<std::size_t> path;
+    for (std::size_t i = 0; i < n; ++i)
     {
-        return -1;
+        std::size_t j = i;
+        while (j != no_parent && states[j] == state::unvisited)
+        {
+            states[j] = state::on_path;
+            path.push_back(j);
+            j = parents[j];
+        }
+        if (j != no_parent && states[j] == state::on_path)
+            parents[j] = no_parent;
+        for (std::size_t k : path)
+            states[k] = state::done;
+        path.clear();
     }
-    else if(b.value_ < a.value_)
+}
+
+} // namespace internal
+
+// API search type: trees_from_sequence_by_keys : ((a -> k), (a -> Maybe k), [a]) -> [Tree a]
+// fwd bind count: 2
+// Converts the sequence into trees, where every element is a child
+// of the element whose key equals its parent key.
+// Elements without parent key, or with one not present, become roots.
+// Children and roots keep the order of the input.
+// If keys are not unique, the first element with a key is the parent.
+// Cycles are broken up by making one of their elements a root.
+// Parents are looked up using a hash map, so the runtime is O(n).
+template <typename KeyF, typename ParentKeyF, typename Container,
+    typename T = typename Container::value_type>
+std::vector<tree<T>> trees_from_sequence_by_keys(
+    KeyF key_of, ParentKeyF parent_key_of, const Container& xs)
+{
+    typedef std::decay_t<detail::invoke_result_t<KeyF, const T&>> Key;
+    const std::size_t n = size_of_cont(xs);
+    const std::size_t no_parent = n;
+
+    std::unordered_map<Key, std::size_t> idxs_by_key;
+    idxs_by_key.reserve(n);
+    std::vector<tree<T>> nodes;
+    nodes.reserve(n);
+    for (const auto& x : xs)
     {
-        return 1;
+        idxs_by_key.emplace(detail::invoke(key_of, x), nodes.size());
+        nodes.push_back(internal::make_singleton_tree(x));
     }
-    else
+
+    std::vector<std::size_t> parents;
+    parents.reserve(n);
+    for (const auto& node : nodes)
     {
-        const auto results = zip_with(tree_cmp<T>,
-            sort_by(tree_cmp<T>, a.children_),
-            sort_by(tree_cmp<T>, b.children_));
-        return just_with_default(0, find_first_by(
-                bind_1st_of_2(is_not_equal<int>, 0),
-                results));
+        const auto parent_key = detail::invoke(parent_key_of, node.value_);
+        const auto it = parent_key.is_just()
+            ? idxs_by_key.find(parent_key.unsafe_get_just())
+            : idxs_by_key.end();
+        parents.push_back(it == idxs_by_key.end() ? no_parent : it->second);
     }
-}
+    internal::break_parent_cycles(parents);
 
-template <typename T>
-bool tree_less(const tree<T>& a, const tree<T>& b)
-{
-    return tree_cmp(a, b) < 0;
-}
+    // Children of node i are children[child_begins[i], child_begins[i+1]).
+    std::vector<std::size_t> child_begins(n + 2, 0);
+    for (std::size_t parent : parents)
+    {
+        if (parent != no_parent)
+            ++child_begins[parent + 2];
+    }
+    for (std::size_t i = 2; i < n + 2; ++i)
+        child_begins[i] += child_begins[i - 1];
+    std::vector<std::size_t> children(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (parents[i] != no_parent)
+            children[child_begins[parents[i] + 1]++] = i;
+    }
 
-} // namespace internal
+    // Breadth-first order, so that walking it backwards
+    // visits all children of a node before the node itself.
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (parents[i] == no_parent)
+            order.push_back(i);
+    }
+    const std::size_t roots_count = order.size();
+    for (std::size_t pos = 0; pos < order.size(); ++pos)
+    {
+        const std::size_t i = order[pos];
+        order.insert(std::end(order),
+            std::begin(children) +
+                static_cast<std::ptrdiff_t>(child_begins[i]),
+            std::begin(children) +
+                static_cast<std::ptrdiff_t>(child_begins[i + 1]));
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        tree<T>& node = nodes[*it];
+        node.children_.reserve(child_begins[*it + 1] - child_begins[*it]);
+        for (std::size_t c = child_begins[*it]; c < child_begins[*it + 1]; ++c)
+            node.children_.push_back(std::move(nodes[children[c]]));
+    }
+
+    std::vector<tree<T>> result;
+    result.reserve(roots_count);
+    for (std::size_t pos = 0; pos < roots_count; ++pos)
+        result.push_back(std::move(nodes[order[pos]]));
+    return result;
+}
 
 namespace internal
 {
 
+// Assigns the same id to all subtrees that are equal
+// regardless of the order of their children (AHU algorithm).
+// The id of a node is looked up by its value and the sorted ids
+// of its children, so every distinct subtree is compared only once.
+// Values equivalent under < only share an id if they are also ==.
 template <typename T>
-bool are_normalized_trees_equal(const tree<T>& a, const tree<T>& b)
+class tree_canonizer
 {
-    if (a.value_ != b.value_ || a.children_.size() != b.children_.size())
-    {
-        return false;
-    }
-    else
+public:
+    tree_canonizer() : ids_(), next_id_(0) {}
+
+    // Returns the id of the root.
+    // If only known subtrees are allowed,
+    // returns nothing as soon as an unknown one shows up.
+    maybe<std::size_t> canonical_id(const tree<T>& x, bool only_known)
     {
-        return all(zip_with(are_normalized_trees_equal<T>,
-            a.children_, b.children_));
+        // Breadth-first order makes the children of every node adjacent.
+        std::vector<const tree<T>*> nodes(1, &x);
+        std::vector<std::size_t> first_children;
+        for (std::size_t pos = 0; pos < nodes.size(); ++pos)
+        {
+            first_children.push_back(nodes.size());
+            for (const auto& c : nodes[pos]->children_)
+            {
+                nodes.push_back(&c);
+            }
+        }
+        std::vector<std::size_t> node_ids(nodes.size());
+        for (std::size_t i = nodes.size(); i-- > 0;)
+        {
+            const auto first = std::begin(node_ids) +
+                static_cast<std::ptrdiff_t>(first_children[i]);
+            key k(&nodes[i]->value_, std::vector<std::size_t>(
+                first, first + static_cast<std::ptrdiff_t>(
+                    nodes[i]->children_.size())));
+            std::sort(std::begin(k.second), std::end(k.second));
+            const T& value = nodes[i]->value_;
+            auto it = ids_.find(k);
+            if (it != std::end(ids_))
+            {
+                const auto same = std::find_if(
+                    std::begin(it->second), std::end(it->second),
+                    [&value](const entry& e) { return *e.first == value; });
+                if (same != std::end(it->second))
+                {
+                    node_ids[i] = same->second;
+                    continue;
+                }
+            }
+            if (only_known)
+                return {};
+            if (it == std::end(ids_))
+                it = ids_.emplace(std::move(k), std::vector<entry>()).first;
+            it->second.emplace_back(&value, next_id_);
+            node_ids[i] = next_id_++;
+        }
+        return node_ids.front();
     }
-}
 
-template <typename T>
-tree<T> normalize_tree(tree<T> x)
-{
-    x.children_ = sort_by(
-        internal::tree_less<T>,
-        transform(normalize_tree<T>, x.children_));
-    return x;
-}
+private:
+    typedef std::pair<const T*, std::vector<std::size_t>> key;
+    typedef std::pair<const T*, std::size_t> entry;
+    struct key_less
+    {
+        bool operator()(const key& a, const key& b) const
+        {
+            if (*a.first < *b.first)
+                return true;
+            if (*b.first < *a.first)
+                return false;
+            return a.second < b.second;
+        }
+    };
+    std::map<key, std::vector<entry>, key_less> ids_;
+    std::size_t next_id_;
+};
 
 } // namespace internal
 
 // API search type: are_trees_equal : (Tree a, Tree a) -> Bool
 // fwd bind count: 1
+// The order of the children does not matter.
+// Values are ordered with < and then compared with ==.
+// O(n * log(n)) comparisons of values.
 template <typename T>
 bool are_trees_equal(const tree<T>& a, const tree<T>& b)
 {
-    return internal::are_normalized_trees_equal(
-        internal::normalize_tree(a), internal::normalize_tree(b));
+    if (a.value_ != b.value_ ||
+        a.children_.size() != b.children_.size() ||
+        tree_size(a) != tree_size(b))
+    {
+        return false;
+    }
+    internal::tree_canonizer<T> canonizer;
+    const auto id_a = canonizer.canonical_id(a, false);
+    return canonizer.canonical_id(b, true) == id_a;
 }
 
 // API search type: tree_size : Tree a -> Int
@@ -191,7 +429,19 @@ bool are_trees_equal(const tree<T>& a, const tree<T>& b)
 template <typename T>
 std::size_t tree_size(const tree<T>& x)
 {
-    return 1 + sum(transform(tree_size<T>, x.children_));
+    std::size_t result = 0;
+    std::vector<const tree<T>*> stack(1, &x);
+    while (!stack.empty())
+    {
+        const auto current = stack.back();
+        stack.pop_back();
+        ++result;
+        for (const auto& c : current->children_)
+        {
+            stack.push_back(&c);
+        }
+    }
+    return result;
 }
 
 // API search type: tree_depth : Tree a -> Int
@@ -200,8 +450,19 @@ std::size_t tree_size(const tree<T>& x)
 template <typename T>
 std::size_t tree_depth(const tree<T>& x)
 {
-    return 1 + just_with_default<std::size_t>(0,
-        maximum_maybe(transform(tree_depth<T>, x.children_)));
+    std::size_t result = 0;
+    std::vector<std::pair<const tree<T>*, std::size_t>> stack(1, {&x, 1});
+    while (!stack.empty())
+    {
+        const auto current = stack.back();
+        stack.pop_back();
+        result = std::max(result, current.second);
+        for (const auto& c : current.first->children_)
+        {
+            stack.emplace_back(&c, current.second + 1);
+        }
+    }
+    return result;
 }
 
 // API search type: flatten_tree_depth_first : Tree a -> [a]
@@ -209,8 +470,21 @@ std::size_t tree_depth(const tree<T>& x)
 template <typename T>
 std::vector<T> flatten_tree_depth_first(const tree<T>& x)
 {
-    return prepend_elem(x.value_,
-        transform_and_concat(flatten_tree_depth_first<T>, x.children_));
+    std::vector<T> result;
+    result.reserve(tree_size(x));
+    std::vector<const tree<T>*> stack(1, &x);
+    while (!stack.empty())
+    {
+        const auto current = stack.back();
+        stack.pop_back();
+        result.push_back(current->value_);
+        for (auto it = current->children_.rbegin();
+            it != current->children_.rend(); ++it)
+        {
+            stack.push_back(&*it);
+        }
+    }
+    return result;
 }
 
 // API search type: flatten_tree_breadth_first : Tree a -> [a]
@@ -235,4 +509,245 @@ std::vector<T> flatten_tree_breadth_first(const tree<T>& x)
     return result;
 }
 
+// A tree stored contiguously, with its nodes in depth-first pre-order.
+// Node 0 is the root, the first child of node i is node i + 1,
+// and the subtree of node i occupies the nodes [i, subtree_end(i)).
+// So the next sibling of a node starts at the end of its subtree.
+// Traversals are linear scans without recursion,
+// and copying one allocates a fixed number of buffers,
+// whereas every node of a tree<T> is an allocation of its own.
+template <typename T>
+class flat_tree
+{
+public:
+    // Copies the values.
+    explicit flat_tree(const tree<T>& x) :
+        values_(), parents_(), subtree_ends_()
+    {
+        init(x);
+    }
+
+    // Moves the values out of x.
+    explicit flat_tree(tree<T>&& x) :
+        values_(), parents_(), subtree_ends_()
+    {
+        init(x);
+    }
+
+    std::size_t size() const { return values_.size(); }
+    const T& value(std::size_t idx) const { return values_[idx]; }
+
+    // All values in depth-first pre-order.
+    const std::vector<T>& values() const { return values_; }
+
+    maybe<std::size_t> parent(std::size_t idx) const
+    {
+        if (parents_[idx] == no_parent())
+            return {};
+        return parents_[idx];
+    }
+
+    std::size_t subtree_end(std::size_t idx) const
+    {
+        return subtree_ends_[idx];
+    }
+
+    std::size_t subtree_size(std::size_t idx) const
+    {
+        return subtree_ends_[idx] - idx;
+    }
+
+    std::vector<std::size_t> child_idxs(std::size_t idx) const
+    {
+        std::vector<std::size_t> result;
+        for (std::size_t c = idx + 1; c < subtree_ends_[idx];
+            c = subtree_ends_[c])
+        {
+            result.push_back(c);
+        }
+        return result;
+    }
+
+    // Copies the subtree rooted at the given node.
+    flat_tree subtree(std::size_t idx) const
+    {
+        const auto begin = std::begin(values_) +
+            static_cast<std::ptrdiff_t>(idx);
+        const auto end = std::begin(values_) +
+            static_cast<std::ptrdiff_t>(subtree_ends_[idx]);
+        std::vector<std::size_t> parents;
+        std::vector<std::size_t> subtree_ends;
+        parents.reserve(subtree_size(idx));
+        subtree_ends.reserve(subtree_size(idx));
+        parents.push_back(no_parent());
+        subtree_ends.push_back(subtree_size(idx));
+        for (std::size_t i = idx + 1; i < subtree_ends_[idx]; ++i)
+        {
+            parents.push_back(parents_[i] - idx);
+            subtree_ends.push_back(subtree_ends_[i] - idx);
+        }
+        return flat_tree(std::vector<T>(begin, end),
+            std::move(parents), std::move(subtree_ends));
+    }
+
+    // Builds the nested tree bottom-up, without recursion.
+    tree<T> to_tree() const
+    {
+        std::vector<tree<T>> nodes;
+        nodes.reserve(size());
+        for (const auto& x : values_)
+        {
+            nodes.push_back(internal::make_singleton_tree(x));
+        }
+        for (std::size_t i = size(); i-- > 0;)
+        {
+            auto& children = nodes[i].children_;
+            for (std::size_t c = i + 1; c < subtree_ends_[i];
+                c = subtree_ends_[c])
+            {
+                children.push_back(std::move(nodes[c]));
+            }
+        }
+        return std::move(nodes.front());
+    }
+
+private:
+    flat_tree(std::vector<T> values, std::vector<std::size_t> parents,
+            std::vector<std::size_t> subtree_ends) :
+        values_(std::move(values)),
+        parents_(std::move(parents)),
+        subtree_ends_(std::move(subtree_ends))
+    {
+    }
+
+    // Walks x depth-first with an explicit stack.
+    // Tree is tree<T> to move the values, const tree<T> to copy them.
+    template <typename Tree>
+    void init(Tree& x)
+    {
+        const std::size_t n = tree_size(x);
+        values_.reserve(n);
+        parents_.reserve(n);
+        std::vector<std::pair<Tree*, std::size_t>> stack(
+            1, {&x, no_parent()});
+        while (!stack.empty())
+        {
+            const auto current = stack.back();
+            stack.pop_back();
+            const std::size_t idx = values_.size();
+            values_.push_back(std::move(current.first->value_));
+            parents_.push_back(current.second);
+            auto& children = current.first->children_;
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+            {
+                stack.emplace_back(&*it, idx);
+            }
+        }
+        subtree_ends_.assign(n, 1);
+        for (std::size_t i = n; i-- > 1;)
+        {
+            subtree_ends_[parents_[i]] += subtree_ends_[i];
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            subtree_ends_[i] += i;
+        }
+    }
+
+    static std::size_t no_parent()
+    {
+        return static_cast<std::size_t>(-1);
+    }
+
+    std::vector<T> values_;
+    std::vector<std::size_t> parents_;
+    std::vector<std::size_t> subtree_ends_;
+};
+
+// API search type: tree_to_flat_tree : Tree a -> FlatTree a
+// fwd bind count: 0
+// Stores the tree contiguously. O(n), no recursion.
+template <typename T>
+flat_tree<T> tree_to_flat_tree(const tree<T>& x)
+{
+    return flat_tree<T>(x);
+}
+
+template <typename T>
+flat_tree<T> tree_to_flat_tree(tree<T>&& x)
+{
+    return flat_tree<T>(std::move(x));
+}
+
+// API search type: flat_tree_to_tree : FlatTree a -> Tree a
+// fwd bind count: 0
+template <typename T>
+tree<T> flat_tree_to_tree(const flat_tree<T>& x)
+{
+    return x.to_tree();
+}
+
+// API search type: flat_subtree : (Int, FlatTree a) -> FlatTree a
+// fwd bind count: 1
+// Returns the subtree rooted at the node with the given index.
+template <typename T>
+flat_tree<T> flat_subtree(std::size_t idx, const flat_tree<T>& x)
+{
+    return x.subtree(idx);
+}
+
+// API search type: flat_tree_depth : FlatTree a -> Int
+// fwd bind count: 0
+// A tree with only one element (root) has depth 1.
+// Only keeps the ends of the subtrees currently entered.
+template <typename T>
+std::size_t flat_tree_depth(const flat_tree<T>& x)
+{
+    std::size_t result = 0;
+    std::vector<std::size_t> open_ends;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        while (!open_ends.empty() && open_ends.back() <= i)
+        {
+            open_ends.pop_back();
+        }
+        open_ends.push_back(x.subtree_end(i));
+        result = std::max(result, open_ends.size());
+    }
+    return result;
+}
+
+// API search type: flatten_flat_tree_depth_first : FlatTree a -> [a]
+// fwd bind count: 0
+template <typename T>
+std::vector<T> flatten_flat_tree_depth_first(const flat_tree<T>& x)
+{
+    return x.values();
+}
+
+// API search type: flatten_flat_tree_breadth_first : FlatTree a -> [a]
+// fwd bind count: 0
+template <typename T>
+std::vector<T> flatten_flat_tree_breadth_first(const flat_tree<T>& x)
+{
+    std::vector<std::size_t> order(1, 0);
+    order.reserve(x.size());
+    for (std::size_t pos = 0; pos < order.size(); ++pos)
+    {
+        const std::size_t i = order[pos];
+        for (std::size_t c = i + 1; c < x.subtree_end(i);
+            c = x.subtree_end(c))
+        {
+            order.push_back(c);
+        }
+    }
+    std::vector<T> result;
+    result.reserve(x.size());
+    for (std::size_t i : order)
+    {
+        result.push_back(x.value(i));
+    }
+    return result;
+}
+
 } // namespace fplus
\ No newline at end of file
@@ -0,0 +1,308 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <fplus/container_traits.hpp>
+
+#include <fplus/detail/invoke.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace fplus
+{
+
+// Read-only sequence whose element i is f(i), computed on access.
+// Nothing is stored besides f and the size, so iterating does not allocate.
+// Returned by the *_lazy functions, e.g. numbers_lazy.
+// Can be passed where fplus expects a container.
+// Functions producing a sequence from it return an std::vector.
+template <typename F>
+class view_by_idx
+{
+public:
+    typedef std::decay_t<detail::invoke_result_t<const F&, std::size_t>>
+        value_type;
+    typedef value_type reference;
+    typedef value_type const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename view_by_idx::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef value_type reference;
+
+        const_iterator() : view_(nullptr), idx_(0) {}
+        const_iterator(const view_by_idx* view, std::size_t idx) :
+            view_(view), idx_(idx)
+        {
+        }
+        value_type operator*() const { return (*view_)[idx_]; }
+        value_type operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+        const_iterator& operator++() { ++idx_; return *this; }
+        const_iterator operator++(int) { auto it = *this; ++idx_; return it; }
+        const_iterator& operator--() { --idx_; return *this; }
+        const_iterator operator--(int) { auto it = *this; --idx_; return it; }
+        const_iterator& operator+=(difference_type n)
+        {
+            idx_ = static_cast<std::size_t>(
+                static_cast<difference_type>(idx_) + n);
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n) { return *this += -n; }
+        friend const_iterator operator+(const_iterator it, difference_type n)
+        {
+            return it += n;
+        }
+        friend const_iterator operator+(difference_type n, const_iterator it)
+        {
+            return it += n;
+        }
+        friend const_iterator operator-(const_iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(
+            const const_iterator& a, const const_iterator& b)
+        {
+            return static_cast<difference_type>(a.idx_) -
+                static_cast<difference_type>(b.idx_);
+        }
+        friend bool operator==(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ == b.idx_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ != b.idx_;
+        }
+        friend bool operator<(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ < b.idx_;
+        }
+        friend bool operator>(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ > b.idx_;
+        }
+        friend bool operator<=(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ <= b.idx_;
+        }
+        friend bool operator>=(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ >= b.idx_;
+        }
+    private:
+        const view_by_idx* view_;
+        std::size_t idx_;
+    };
+    typedef const_iterator iterator;
+
+    view_by_idx(F f, std::size_t size) : f_(f), size_(size) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    value_type operator[](std::size_t idx) const
+    {
+        assert(idx < size_);
+        return detail::invoke(f_, idx);
+    }
+    value_type front() const { return (*this)[0]; }
+    value_type back() const { return (*this)[size_ - 1]; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+private:
+    F f_;
+    std::size_t size_;
+};
+
+// Read-only sequence [x, f(x), f(f(x)), ...] of a given size,
+// computed while iterating.
+// Every pass over it calls f again, so f should be pure.
+template <typename F, typename T>
+class iterate_view
+{
+public:
+    typedef T value_type;
+    typedef const T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const_iterator() : view_(nullptr), idx_(0), current_() {}
+        const_iterator(const iterate_view* view, std::size_t idx) :
+            view_(view), idx_(idx), current_(view->x_)
+        {
+        }
+        const T& operator*() const { return current_; }
+        const T* operator->() const { return &current_; }
+        const_iterator& operator++()
+        {
+            ++idx_;
+            if (idx_ < view_->size_)
+                current_ = detail::invoke(view_->f_, current_);
+            return *this;
+        }
+        const_iterator operator++(int) { auto it = *this; ++*this; return it; }
+        friend bool operator==(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ == b.idx_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b)
+        {
+            return a.idx_ != b.idx_;
+        }
+    private:
+        const iterate_view* view_;
+        std::size_t idx_;
+        T current_;
+    };
+    typedef const_iterator iterator;
+
+    iterate_view(F f, std::size_t size, const T& x) :
+        f_(f), size_(size), x_(x)
+    {
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& front() const { assert(size_ > 0); return x_; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+private:
+    F f_;
+    std::size_t size_;
+    T x_;
+};
+
+// Read-only subsequence [begin, end) of another container,
+// e.g. one window returned by aperture_lazy.
+// The elements are not copied but accessed in the source,
+// which thus has to outlive the view.
+// materialize copies them into an std::vector.
+template <typename Iterator>
+class segment_view
+{
+public:
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+    typedef typename std::iterator_traits<Iterator>::reference reference;
+    typedef reference const_reference;
+    typedef std::size_t size_type;
+    typedef typename std::iterator_traits<Iterator>::difference_type
+        difference_type;
+    typedef Iterator const_iterator;
+    typedef Iterator iterator;
+
+    segment_view(Iterator begin, Iterator end) : begin_(begin), end_(end) {}
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(std::distance(begin_, end_));
+    }
+    bool empty() const { return begin_ == end_; }
+    reference operator[](std::size_t idx) const
+    {
+        assert(idx < size());
+        return begin_[static_cast<difference_type>(idx)];
+    }
+    reference front() const { assert(!empty()); return *begin_; }
+    reference back() const { assert(!empty()); return *std::prev(end_); }
+    Iterator begin() const { return begin_; }
+    Iterator end() const { return end_; }
+    Iterator cbegin() const { return begin_; }
+    Iterator cend() const { return end_; }
+private:
+    Iterator begin_;
+    Iterator end_;
+};
+
+namespace internal
+{
+
+template <typename F>
+struct has_order<view_by_idx<F>> : public std::true_type {};
+template <typename F, typename T>
+struct has_order<iterate_view<F, T>> : public std::true_type {};
+template <typename Iterator>
+struct has_order<segment_view<Iterator>> : public std::true_type {};
+
+template <typename F, typename NewT, int SizeOffset>
+struct same_cont_new_t<view_by_idx<F>, NewT, SizeOffset>
+{
+    typedef std::vector<NewT> type;
+};
+template <typename F, typename T, typename NewT, int SizeOffset>
+struct same_cont_new_t<iterate_view<F, T>, NewT, SizeOffset>
+{
+    typedef std::vector<NewT> type;
+};
+template <typename Iterator, typename NewT, int SizeOffset>
+struct same_cont_new_t<segment_view<Iterator>, NewT, SizeOffset>
+{
+    typedef std::vector<NewT> type;
+};
+
+// Views can not be modified, so even rvalues are never reused.
+template <typename F>
+struct can_reuse<view_by_idx<F>>
+{
+    using value = create_new_container_t;
+};
+template <typename F, typename T>
+struct can_reuse<iterate_view<F, T>>
+{
+    using value = create_new_container_t;
+};
+template <typename Iterator>
+struct can_reuse<segment_view<Iterator>>
+{
+    using value = create_new_container_t;
+};
+
+template <typename F>
+struct materialized<view_by_idx<F>>
+{
+    typedef std::vector<typename view_by_idx<F>::value_type> type;
+};
+template <typename F, typename T>
+struct materialized<iterate_view<F, T>>
+{
+    typedef std::vector<T> type;
+};
+template <typename Iterator>
+struct materialized<segment_view<Iterator>>
+{
+    typedef std::vector<typename segment_view<Iterator>::value_type> type;
+};
+
+} // namespace internal
+
+} // namespace fplus
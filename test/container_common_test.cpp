@@ -7,6 +7,10 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
 #include <vector>
 
 namespace {
@@ -380,6 +384,76 @@ TEST_CASE("container_common_test, sort")
     REQUIRE_EQ(sort_on(size_of_cont<IntVector>, IntVectors({{1,2,3},{4,5}})), IntVectors({{4,5},{1,2,3}}));
 }
 
+TEST_CASE("container_common_test, sort_large")
+{
+    using namespace fplus;
+    std::mt19937 gen(42);
+    std::vector<std::uint64_t> ids(10000);
+    for (auto& id : ids)
+        id = (static_cast<std::uint64_t>(gen()) << 32) | gen();
+    auto ids_sorted = ids;
+    std::sort(std::begin(ids_sorted), std::end(ids_sorted));
+    REQUIRE_EQ(sort(ids), ids_sorted);
+    REQUIRE_EQ(stable_sort(ids), ids_sorted);
+
+    std::vector<int> ints(1000);
+    for (auto& x : ints)
+        x = static_cast<int>(gen() % 2001) - 1000;
+    auto ints_sorted = ints;
+    std::sort(std::begin(ints_sorted), std::end(ints_sorted));
+    REQUIRE_EQ(sort(ints), ints_sorted);
+    REQUIRE_EQ(sort(std::vector<short>(300, 5)), std::vector<short>(300, 5));
+
+    std::vector<double> doubles(1000);
+    for (auto& x : doubles)
+        x = std::ldexp(static_cast<double>(gen()) - 2147483648.0,
+            static_cast<int>(gen() % 40) - 20);
+    doubles[7] = std::numeric_limits<double>::infinity();
+    doubles[8] = -std::numeric_limits<double>::infinity();
+    auto doubles_sorted = doubles;
+    std::sort(std::begin(doubles_sorted), std::end(doubles_sorted));
+    REQUIRE_EQ(sort(doubles), doubles_sorted);
+
+    std::vector<std::string> strs(2000);
+    for (auto& str : strs)
+    {
+        str.resize(gen() % 5);
+        for (auto& c : str)
+            c = static_cast<char>("ab\xff"[gen() % 3]);
+    }
+    auto strs_sorted = strs;
+    std::sort(std::begin(strs_sorted), std::end(strs_sorted));
+    REQUIRE_EQ(sort(strs), strs_sorted);
+    REQUIRE_EQ(sort(convert_container<std::deque<std::string>>(strs)),
+        convert_container<std::deque<std::string>>(strs_sorted));
+    REQUIRE_EQ(lexicographical_sort(strs),
+        sort_by(lexicographical_less<std::string>, strs));
+
+    // Organ-pipe keys make middle-element pivots unbalanced.
+    IntVectors organ_pipe;
+    for (int i = 0; i < 20000; ++i)
+        organ_pipe.push_back({i < 10000 ? i : 20000 - i, i % 3});
+    auto organ_pipe_sorted = organ_pipe;
+    std::sort(std::begin(organ_pipe_sorted), std::end(organ_pipe_sorted));
+    REQUIRE_EQ(lexicographical_sort(organ_pipe), organ_pipe_sorted);
+
+    std::vector<std::string> long_prefixes;
+    for (int i = 0; i < 300; ++i)
+        long_prefixes.push_back(std::string(5000, 'x') +
+            std::to_string((i * 7919) % 300));
+    auto long_prefixes_sorted = long_prefixes;
+    std::sort(std::begin(long_prefixes_sorted),
+        std::end(long_prefixes_sorted));
+    REQUIRE_EQ(sort(long_prefixes), long_prefixes_sorted);
+
+    std::size_t key_calls = 0;
+    const auto key = [&key_calls](int x) { ++key_calls; return x / 10; };
+    const auto by_key = sort_on(key, ints);
+    REQUIRE_EQ(key_calls, ints.size());
+    REQUIRE_EQ(by_key, stable_sort_by([](int x, int y) { return x / 10 < y / 10; }, ints));
+    REQUIRE_EQ(sort_on(key, IntList({31, 5, 22, 38, 1})), IntList({5, 1, 22, 31, 38}));
+}
+
 TEST_CASE("container_common_test, stable_sort")
 {
     using namespace fplus;
@@ -389,6 +463,23 @@ TEST_CASE("container_common_test, stable_sort")
 
     REQUIRE_EQ(stable_sort_on(int_mod_10, IntVector({26,3,14})), IntVector({3,14,26}));
     REQUIRE_EQ(stable_sort_on(size_of_cont<IntVector>, IntVectors({{1,2,3},{4,5}})), IntVectors({{4,5},{1,2,3}}));
+
+    IntPairs pairs;
+    for (int i = 0; i < 100; ++i)
+        pairs.push_back(IntPair(i % 3, i));
+    const auto sorted_pairs = stable_sort_by(
+        [](const IntPair& a, const IntPair& b) { return a.first < b.first; },
+        pairs);
+    REQUIRE(is_sorted(sorted_pairs));
+
+    typedef std::pair<double, int> DoubleIntPair;
+    std::vector<DoubleIntPair> signed_zeros;
+    for (int i = 0; i < 600; ++i)
+        signed_zeros.push_back(DoubleIntPair(i % 2 == 0 ? 0.0 : -0.0, i));
+    const auto get_key = [](const DoubleIntPair& p) { return p.first; };
+    REQUIRE_EQ(transform(snd<double, int>,
+            stable_sort_on(get_key, signed_zeros)),
+        transform(snd<double, int>, signed_zeros));
 }
 
 TEST_CASE("container_common_test, partial_sort")
@@ -512,6 +603,15 @@ TEST_CASE("container_common_test, elem_at_idx")
 
 }
 
+TEST_CASE("container_common_test, elems_at_idxs")
+{
+    using namespace fplus;
+    const IdxVector idxs = {3, 0, 3, 1};
+    REQUIRE_EQ(elems_at_idxs(idxs, xs), IntVector({3,1,3,2}));
+    REQUIRE_EQ(elems_at_idxs(idxs, intList), IntVector({3,1,3,2}));
+    REQUIRE_EQ(elems_at_idxs(IdxVector(), intList), IntVector());
+}
+
 TEST_CASE("container_common_test, elem_at_idx_maybe")
 {
     using namespace fplus;
@@ -636,6 +736,11 @@ TEST_CASE("container_common_test, count_occurrences")
     typedef std::map<int, std::size_t> IntSizeTMap;
     IntSizeTMap OccurrencesResult = {{1, 1}, {2, 3}, {3, 1}};
     REQUIRE_EQ(count_occurrences(xs), OccurrencesResult);
+    typedef std::unordered_map<int, std::size_t> IntSizeTUnorderedMap;
+    const auto unordered_occurrences =
+        count_occurrences<IntVector, IntSizeTUnorderedMap>(xs);
+    REQUIRE_EQ(unordered_occurrences,
+        IntSizeTUnorderedMap({{1, 1}, {2, 3}, {3, 1}}));
 }
 
 TEST_CASE("container_common_test, insert_at")
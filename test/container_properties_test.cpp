@@ -7,6 +7,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <cmath>
+#include <limits>
+#include <list>
 #include <vector>
 
 namespace {
@@ -72,6 +75,44 @@ TEST_CASE("container_properties_test, minmax")
 
     REQUIRE_EQ(minimum_idx_on(negateInt, xs), 3);
     REQUIRE_EQ(maximum_idx_on(negateInt, xs), 0);
+
+    REQUIRE_EQ(minmax(xs), std::make_pair(1, 3));
+    REQUIRE_EQ(minmax_idx(xs), std::make_pair<std::size_t, std::size_t>(0, 3));
+    REQUIRE_EQ(minmax_idx(std::list<int>({3, 1, 4, 2, 4, 1})),
+        std::make_pair<std::size_t, std::size_t>(1, 2));
+    REQUIRE_EQ(minmax_maybe(IntVector()), nothing<std::pair<int, int>>());
+    REQUIRE_EQ(minmax_idx_maybe(IntVector({5})),
+        just(std::make_pair<std::size_t, std::size_t>(0, 0)));
+}
+
+TEST_CASE("container_properties_test, minmax_large")
+{
+    using namespace fplus;
+    std::vector<int> ys(1000, 7);
+    ys[123] = -5;
+    ys[567] = -5;
+    ys[300] = 99;
+    ys[998] = 99;
+    REQUIRE_EQ(minimum(ys), -5);
+    REQUIRE_EQ(maximum(ys), 99);
+    REQUIRE_EQ(minimum_idx(ys), 123);
+    REQUIRE_EQ(maximum_idx(ys), 300);
+    REQUIRE_EQ(minmax(ys), std::make_pair(-5, 99));
+    REQUIRE_EQ(minmax_idx(ys), std::make_pair<std::size_t, std::size_t>(123, 300));
+    ys[999] = -6;
+    REQUIRE_EQ(minimum_idx(ys), 999);
+    REQUIRE_EQ(minmax_idx(ys), std::make_pair<std::size_t, std::size_t>(999, 300));
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> ds = {2.0, nan, 1.0, 3.0, nan, 0.5, 2.5, 0.5, 1.5, 3.0};
+    REQUIRE_EQ(minimum(ds), 0.5);
+    REQUIRE_EQ(maximum(ds), 3.0);
+    REQUIRE_EQ(minimum_idx(ds), 5);
+    REQUIRE_EQ(maximum_idx(ds), 3);
+    REQUIRE_EQ(minmax_idx(ds), std::make_pair<std::size_t, std::size_t>(5, 3));
+    ds[0] = nan;
+    REQUIRE_EQ(minimum_idx(ds), 0);
+    REQUIRE_EQ(maximum_idx(ds), 0);
 }
 
 TEST_CASE("container_properties_test, minmax_maybe")
@@ -117,6 +158,110 @@ TEST_CASE("container_properties_test, mean")
     REQUIRE(is_in_interval(1.99, 2.01, mean_stddev<double>(DoubleVector({ 4, 8 })).second));
     REQUIRE(is_in_interval(3.749f, 3.751f, mean_stddev<float>(IntVector({ 1, 3, 7, 4 })).first));
     REQUIRE(is_in_interval(2.16f, 2.17f, mean_stddev<float>(IntVector({ 1, 3, 7, 4 })).second));
+    REQUIRE(is_in_interval(2.16f, 2.17f, mean_stddev<float>(std::list<int>({ 1, 3, 7, 4 })).second));
+    REQUIRE_EQ(mean_stddev<int>(IntVector({ 1, 3, 7, 5 })), std::make_pair(4, 2));
+}
+
+TEST_CASE("container_properties_test, quantiles")
+{
+    using namespace fplus;
+    typedef std::vector<double> Doubles;
+    REQUIRE_EQ(median(std::list<int>({ 5, 6, 4, 3, 2, 6, 7, 9, 3 })), 5);
+    REQUIRE_EQ(median(IntVector({ 8, 1, 5, 3 })), 4);
+    REQUIRE_EQ(quantiles(Doubles({0, 0.25, 0.5, 1}), IntVector({5, 1, 4, 2, 3})),
+        IntVector({1, 2, 3, 5}));
+    REQUIRE_EQ(quantiles(Doubles({0.5}), std::list<double>({4, 1, 3, 2})),
+        Doubles({2.5}));
+    REQUIRE_EQ(quantiles(Doubles({-1, 0.1, 0.9, 0.9, 2}), Doubles({7, 1, 3, 5, 9, 0})),
+        Doubles({0, 0.5, 8, 8, 9}));
+    const auto xs_shuffled = shuffle(std::uint_fast32_t(3), numbers<int>(0, 1001));
+    REQUIRE_EQ(quantiles(Doubles({0.75, 0.125, 0.5, 0.25}), xs_shuffled),
+        IntVector({750, 125, 500, 250}));
+    REQUIRE_EQ(quantiles(Doubles({0.5}), IntVector({1, 2, 3, 4})),
+        IntVector({2}));
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    REQUIRE_EQ(quantiles(Doubles({nan, 1}), IntVector({5, 1, 4, 2, 3})),
+        IntVector({1, 5}));
+}
+
+TEST_CASE("container_properties_test, quantile_sketch")
+{
+    using namespace fplus;
+    quantile_sketch<int> sketch_empty;
+    REQUIRE_EQ(sketch_empty.size(), 0);
+
+    quantile_sketch<int> sketch_small;
+    for (int x : IntVector({5, 1, 4, 2, 3}))
+        sketch_small.add(x);
+    REQUIRE_EQ(sketch_small.quantiles(std::vector<double>({0, 0.5, 1})),
+        IntVector({1, 3, 5}));
+    REQUIRE_EQ(sketch_small.quantile(std::numeric_limits<double>::quiet_NaN()),
+        1);
+
+    const auto xs_shuffled = shuffle(std::uint_fast32_t(5), numbers<int>(0, 100000));
+    quantile_sketch<int> sketch_1(200);
+    quantile_sketch<int> sketch_2(200);
+    for (std::size_t i = 0; i < xs_shuffled.size(); ++i)
+        (i % 3 == 0 ? sketch_1 : sketch_2).add(xs_shuffled[i]);
+    sketch_1.merge(sketch_2);
+    REQUIRE_EQ(sketch_1.size(), 100000);
+    REQUIRE_EQ(sketch_1.quantile(0), 0);
+    REQUIRE_EQ(sketch_1.quantile(1), 99999);
+    for (double p : std::vector<double>({0.01, 0.25, 0.5, 0.9, 0.99}))
+    {
+        const double expected = p * 99999.0;
+        const double actual = static_cast<double>(sketch_1.quantile(p));
+        REQUIRE(is_in_interval_around(2000.0, expected, actual));
+    }
+}
+
+TEST_CASE("container_properties_test, mean_stddev_large")
+{
+    using namespace fplus;
+    // Large offset, small variance: naive sum of squares would fail.
+    std::vector<double> xs(300001);
+    for (std::size_t i = 0; i < xs.size(); ++i)
+        xs[i] = 1e9 + (i % 2 == 0 ? 1.0 : -1.0);
+    const auto expected_stddev = std::sqrt(1.0 - 1.0 / 300001.0 / 300001.0);
+    const auto m1 = mean_stddev<double>(xs);
+    REQUIRE(is_in_interval(1e9 + 3e-6, 1e9 + 4e-6, m1.first));
+    REQUIRE(is_in_interval(expected_stddev - 1e-6, expected_stddev + 1e-6, m1.second));
+    const auto m2 = mean_stddev_parallelly<double>(xs);
+    REQUIRE(is_in_interval(1e9 + 3e-6, 1e9 + 4e-6, m2.first));
+    REQUIRE(is_in_interval(expected_stddev - 1e-6, expected_stddev + 1e-6, m2.second));
+    const auto m3 = mean_stddev_parallelly<double>(
+        convert_container<std::list<double>>(xs));
+    REQUIRE(is_in_interval(expected_stddev - 1e-6, expected_stddev + 1e-6, m3.second));
+    REQUIRE_EQ(mean_stddev_parallelly<double>(std::vector<double>({ 4, 8 })),
+        std::make_pair(6.0, 2.0));
+}
+
+TEST_CASE("container_properties_test, sum_large")
+{
+    using namespace fplus;
+    const auto ints = numbers<int>(0, 1001);
+    REQUIRE_EQ(sum(ints), 500500);
+    REQUIRE_EQ(sum(convert_container<std::list<int>>(ints)), 500500);
+    REQUIRE_EQ(sum(std::vector<unsigned char>(300, 1)), 44);
+    REQUIRE_EQ(product(std::vector<long>(9, 2)), 512);
+    REQUIRE_EQ(product(std::vector<double>(11, 0.5)), 1.0 / 2048.0);
+    REQUIRE_EQ(mean_using_doubles<int>(std::vector<int>(13, 2000000000)),
+        2000000000);
+    const auto doubles = convert_elems<double>(ints);
+    REQUIRE_EQ(sum(doubles), 500500.0);
+    REQUIRE_EQ(sum_pairwise(doubles), 500500.0);
+    REQUIRE_EQ(sum_pairwise(IntVector()), 0);
+    REQUIRE_EQ(sum_pairwise(numbers<long long>(0, 100000)), 4999950000);
+    REQUIRE_EQ(sum_kahan(std::vector<double>({1e100, 1.0, -1e100})), 1.0);
+    REQUIRE_EQ(sum_kahan(std::vector<double>(10, 0.1)), 1.0);
+
+    // Element i goes to lane i % 8, so 1e8 and -1e8 cancel out in lane 0
+    // before the ones are lost to rounding as in a sequential loop.
+    std::vector<float> floats(16, 1.0f);
+    floats[0] = 1e8f;
+    floats[8] = -1e8f;
+    REQUIRE_EQ(sum(floats), 14.0f);
+    REQUIRE_EQ(sum(convert_container<std::list<float>>(floats)), 7.0f);
 }
 
 TEST_CASE("container_properties_test, all_unique_less")
@@ -147,6 +292,13 @@ TEST_CASE("container_properties_test, subsequence")
     REQUIRE_EQ(is_subsequence_of(IntVector(), xs), true);
     REQUIRE_EQ(is_subsequence_of(IntVector({ 1,3 }), xs), true);
     REQUIRE_EQ(is_subsequence_of(IntVector({ 3,1 }), xs), false);
+    REQUIRE_EQ(is_subsequence_of(IntVector({ 2,2,2 }), xs), true);
+    REQUIRE_EQ(is_subsequence_of(IntVector({ 2,2,2,2 }), xs), false);
+    typedef std::list<int> IntList;
+    REQUIRE(is_subsequence_of(IntList({ 1,2,3 }), IntList({ 1,4,2,5,3 })));
+    REQUIRE_FALSE(is_subsequence_of(IntList({ 1,3,2 }), IntList({ 1,2,3 })));
+    REQUIRE(is_subsequence_of(std::string("Final"),
+        std::string("FunctionalPlus")));
 }
 
 TEST_CASE("container_properties_test, count")
@@ -169,6 +321,13 @@ TEST_CASE("container_properties_test, is_permutation_of")
     REQUIRE_FALSE(is_permutation_of(IntVector({2,3,2}), IntVector({1,2,3})));
     REQUIRE_FALSE(is_permutation_of(IntVector({2,3}), IntVector({1,2,3})));
     REQUIRE_FALSE(is_permutation_of(IntVector({2,3,1}), IntVector({1,23})));
+    REQUIRE_FALSE(is_permutation_of(IntVector({1,1,2}), IntVector({1,2,2})));
+    REQUIRE(is_permutation_of(std::string("listen"), std::string("silent")));
+    typedef std::vector<IntVector> IntVectors;
+    REQUIRE(is_permutation_of(IntVectors({{1}, {2, 3}, {1}}),
+        IntVectors({{2, 3}, {1}, {1}})));
+    REQUIRE_FALSE(is_permutation_of(IntVectors({{1}, {2, 3}}),
+        IntVectors({{3, 2}, {1}})));
 }
 
 TEST_CASE("container_properties_test, fill_pigeonholes")
@@ -188,4 +347,6 @@ TEST_CASE("container_properties_test, present_in_all")
     using namespace fplus;
     const std::vector<std::vector<int>> xss = { {4,1,2}, {5,2,1}, {2,4,1} };
     REQUIRE_EQ(present_in_all(xss), IntVector({1,2}));
+    const std::list<std::list<int>> xss_list = { {4,1,2,1}, {5,2,1}, {2,4,1} };
+    REQUIRE_EQ(present_in_all(xss_list), IntVector({1,2}));
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <list>
 #include <vector>
 
 namespace {
@@ -101,6 +102,13 @@ TEST_CASE("filter_test, keep_idxs")
     const std::vector<std::size_t> indices = { 2, 5 };
     auto result = fplus::keep_idxs(indices, v);
     REQUIRE_EQ(result, std::vector<int>({3, 6}));
+
+    const std::list<int> l = { 1, 2, 3, 4, 5, 6, 7 };
+    const std::vector<std::size_t> unsorted_indices = { 9, 5, 2, 5, 0 };
+    REQUIRE_EQ(fplus::keep_idxs(unsorted_indices, l),
+        std::list<int>({1, 3, 6}));
+    REQUIRE_EQ(fplus::keep_idxs(unsorted_indices, v),
+        std::vector<int>({1, 3, 6}));
 }
 
 TEST_CASE("filter_test, drop_idx")
@@ -116,6 +124,13 @@ TEST_CASE("filter_test, drop_idxs")
     const std::vector<std::size_t> indices = { 2, 5 };
     auto result = fplus::drop_idxs(indices, v);
     REQUIRE_EQ(result, std::vector<int>({1, 2, 4, 5, 7}));
+
+    const std::list<int> l = { 1, 2, 3, 4, 5, 6, 7 };
+    const std::vector<std::size_t> unsorted_indices = { 9, 5, 2, 5, 0 };
+    REQUIRE_EQ(fplus::drop_idxs(unsorted_indices, l),
+        std::list<int>({2, 4, 5, 7}));
+    REQUIRE_EQ(fplus::drop_idxs(unsorted_indices, v),
+        std::vector<int>({2, 4, 5, 7}));
 }
 
 TEST_CASE("filter_test, justs")
@@ -7,6 +7,31 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <array>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::size_t allocation_count = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
 
 namespace {
     typedef std::vector<int> IntVector;
@@ -215,6 +240,39 @@ TEST_CASE("fwd_test, keep_if_r_value")
     REQUIRE_EQ(result, std::vector<int>({2, 2, 4}));
 }
 
+TEST_CASE("fwd_test, apply_reuses_r_values")
+{
+    using namespace fplus;
+    const auto drop_odds = fwd::drop_if(is_odd_int);
+    const auto take_some = fwd::take(std::size_t(400));
+    const auto drop_some = fwd::drop(std::size_t(10));
+    const auto trim_zeros = fwd::trim(0);
+    const auto drop_a_few =
+        fwd::drop_idxs(std::array<std::size_t, 4>({{7, 3, 3, 100}}));
+    const auto add_idxs = fwd::transform_with_idx(
+        [](std::size_t i, int x) { return x + static_cast<int>(i); });
+    const auto clip_negatives = fwd::replace_if(is_negative<int>, 0);
+    const auto clip = fwd::winsorize(0.1);
+
+    IntVector xs = numbers(0, 1000);
+    const std::size_t allocations_before = allocation_count;
+    const auto ys = fwd::apply(std::move(xs),
+        drop_odds, take_some, drop_some, trim_zeros, drop_a_few,
+        fwd::reverse(), add_idxs, clip_negatives, fwd::take_while(
+            is_positive<int>), fwd::drop_while(is_even_int), clip);
+    // Only drop_idxs needs a buffer, for its sorted indices.
+    REQUIRE_EQ(allocation_count - allocations_before, 1);
+    REQUIRE_EQ(ys.size(), 386);
+    REQUIRE(is_sorted(ys));
+
+    IntVector zs = {1, 2, 3};
+    const std::size_t allocations_before_growing = allocation_count;
+    const auto zs_grown = fwd::apply(std::move(zs),
+        fwd::intersperse(0), fwd::replicate_elems(std::size_t(2)));
+    REQUIRE_EQ(allocation_count - allocations_before_growing, 2);
+    REQUIRE_EQ(zs_grown, IntVector({1, 1, 0, 0, 2, 2, 0, 0, 3, 3}));
+}
+
 TEST_CASE("fwd_test, zip_with")
 {
     using namespace fplus;
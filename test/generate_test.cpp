@@ -7,6 +7,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <atomic>
 #include <vector>
 #include <utility>
 
@@ -55,6 +56,81 @@ TEST_CASE("generate_test, replicate")
     REQUIRE_EQ(result, std::vector<int>({1, 1, 1}));
 }
 
+TEST_CASE("generate_test, lazy_sources")
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    const auto xs = numbers_lazy(2, 9);
+    REQUIRE_EQ(size_of_cont(xs), 7);
+    REQUIRE_EQ(convert_container<Ints>(xs), numbers(2, 9));
+    REQUIRE_EQ(convert_container<Ints>(numbers_step_lazy(2, 9, 2)),
+        Ints({2, 4, 6, 8}));
+    REQUIRE_EQ(convert_container<Ints>(numbers_step_lazy(2, 8, 2)),
+        Ints({2, 4, 6}));
+    REQUIRE_EQ(convert_container<Ints>(numbers_step_lazy(9, 2, -2)),
+        Ints({9, 7, 5, 3}));
+    REQUIRE(is_empty(numbers_lazy(3, 3)));
+    REQUIRE_EQ(size_of_cont(numbers_step_lazy(0.0, 1.0, 0.25)), 4);
+
+    REQUIRE_EQ(sum(numbers_lazy<std::int64_t>(0, 15000000)),
+        112499992500000);
+    REQUIRE_EQ(fold_left(std::plus<int>(), 0, numbers_lazy(0, 10)), 45);
+    REQUIRE_EQ(transform(square<int>, numbers_lazy(1, 4)), Ints({1, 4, 9}));
+    REQUIRE_EQ(keep_if(is_even<int>, numbers_lazy(1, 8)), Ints({2, 4, 6}));
+    REQUIRE_EQ(fwd::apply(numbers_lazy(0, 10),
+            fwd::drop_if(is_even<int>),
+            fwd::transform(multiply_with(2)),
+            fwd::sum()),
+        50);
+
+    REQUIRE_EQ(convert_container<Ints>(replicate_lazy(3, 1)), Ints({1, 1, 1}));
+    REQUIRE_EQ(convert_container<Ints>(repeat_lazy(3, Ints({1, 2}))),
+        Ints({1, 2, 1, 2, 1, 2}));
+    REQUIRE(is_empty(repeat_lazy(3, Ints())));
+    const auto plus_ten = [](std::size_t i) { return static_cast<int>(i) + 10; };
+    REQUIRE_EQ(convert_container<Ints>(generate_by_idx_lazy(plus_ten, 3)),
+        Ints({10, 11, 12}));
+
+    const auto doubles = iterate_lazy(multiply_with(2), 5, 3);
+    REQUIRE_EQ(convert_container<Ints>(doubles), Ints({3, 6, 12, 24, 48}));
+    REQUIRE_EQ(sum(doubles), 93);
+    REQUIRE(is_empty(iterate_lazy(multiply_with(2), 0, 3)));
+}
+
+TEST_CASE("generate_test, lazy_windows")
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    typedef std::vector<Ints> Intss;
+    const auto materialize_all = [](const auto& windows)
+    {
+        return transform(fwd::materialize(), windows);
+    };
+    const Ints xs = {0, 1, 2, 3, 4, 5, 6};
+
+    const auto windows = aperture_lazy(5, xs);
+    REQUIRE_EQ(size_of_cont(windows), 3);
+    REQUIRE_EQ(materialize_all(windows), aperture(5, xs));
+    REQUIRE_EQ(&windows[1].front(), &xs[1]);
+    REQUIRE_EQ(transform(fwd::sum(), windows), Ints({10, 15, 20}));
+    REQUIRE_EQ(materialize_all(infixes_lazy(3, xs)), infixes(3, xs));
+    REQUIRE(is_empty(infixes_lazy(8, xs)));
+
+    REQUIRE_EQ(materialize_all(inits_lazy(xs)), inits(xs));
+    REQUIRE_EQ(materialize_all(tails_lazy(xs)), tails(xs));
+    const Ints empty;
+    REQUIRE_EQ(materialize_all(inits_lazy(empty)), Intss({{}}));
+    REQUIRE_EQ(materialize_all(rotations_left_lazy(xs)), rotations_left(xs));
+    REQUIRE_EQ(materialize_all(rotations_right_lazy(xs)),
+        rotations_right(xs));
+    REQUIRE(is_empty(rotations_left_lazy(empty)));
+
+    const auto ys = numbers_lazy<std::size_t>(0, 1000000);
+    const auto moving_sums = transform(fwd::sum(), aperture_lazy(64, ys));
+    REQUIRE_EQ(moving_sums.size(), 1000000 - 63);
+    REQUIRE_EQ(moving_sums.back(), sum(numbers<std::size_t>(999936, 1000000)));
+}
+
 TEST_CASE("generate_test, infixes")
 {
     const std::vector<int> v = { 1, 2, 3, 4, 5, 6 };
@@ -140,6 +216,79 @@ TEST_CASE("generate_test, carthesian_product_n_with_power_0")
     REQUIRE(result[0].empty());
 }
 
+TEST_CASE("generate_test, carthesian_product_n_lazy")
+{
+    using namespace fplus;
+    const std::string abcd = "ABCD";
+    const auto lazy = carthesian_product_n_lazy(2, abcd);
+    REQUIRE_EQ(size_of_cont(lazy), 16);
+    REQUIRE_EQ(lazy[6], std::string("BC"));
+    REQUIRE_EQ(convert_container<std::vector<std::string>>(lazy),
+        carthesian_product_n(2, abcd));
+    REQUIRE_EQ(size_of_cont(carthesian_product_n_lazy(0, abcd)), 1);
+    REQUIRE(is_empty(carthesian_product_n_lazy(2, std::string())));
+
+    const auto huge = carthesian_product_n_lazy(30, std::string("01"));
+    REQUIRE_EQ(size_of_cont(huge), std::size_t(1) << 30);
+    REQUIRE_EQ(huge[5], std::string(27, '0') + "101");
+}
+
+TEST_CASE("generate_test, carthesian_product_n_overflow")
+{
+    using namespace fplus;
+    const std::string abcd = "ABCD";
+    const std::size_t power = 8 * sizeof(std::size_t);
+    std::string thrown_str;
+    try
+    {
+        carthesian_product_n_lazy(power, abcd);
+    }
+    catch (const std::overflow_error& e)
+    {
+        thrown_str = e.what();
+    }
+    REQUIRE_EQ(thrown_str, std::string("carthesian_product_n: too large"));
+
+    std::size_t calls = 0;
+    thrown_str.clear();
+    try
+    {
+        for_each_carthesian_product_n_parallelly(
+            [&calls](const std::vector<char>&) { ++calls; }, power, abcd);
+    }
+    catch (const std::overflow_error& e)
+    {
+        thrown_str = e.what();
+    }
+    REQUIRE_EQ(thrown_str, std::string("carthesian_product_n: too large"));
+    REQUIRE_EQ(calls, 0);
+}
+
+TEST_CASE("generate_test, for_each_carthesian_product_n")
+{
+    using namespace fplus;
+    const std::string abc = "ABC";
+    std::vector<std::string> visited;
+    for_each_carthesian_product_n([&visited](const std::vector<char>& t)
+        {
+            visited.push_back(std::string(std::begin(t), std::end(t)));
+        }, 3, abc);
+    REQUIRE_EQ(visited, carthesian_product_n(3, abc));
+
+    std::atomic<std::size_t> count(0);
+    std::atomic<std::size_t> checksum(0);
+    const auto digits = numbers<std::size_t>(0, 10);
+    for_each_carthesian_product_n_parallelly(
+        [&count, &checksum](const std::vector<std::size_t>& t)
+        {
+            ++count;
+            checksum += t[0] * 100000 + t[5];
+        }, 6, digits);
+    REQUIRE_EQ(count.load(), 1000000);
+    REQUIRE_EQ(checksum.load(),
+        std::size_t(45) * 100000 * 100000 + 45 * 100000);
+}
+
 TEST_CASE("generate_test, permutations")
 {
     const std::vector<char> v = { 'A', 'B' };
@@ -366,6 +515,17 @@ TEST_CASE("generate_test, inner_product")
     REQUIRE_EQ(fplus::inner_product(0, xs, ys), 32);
     REQUIRE_EQ(fplus::inner_product_with(plus, mult, 0, xs, ys), 32);
     REQUIRE_EQ(fplus::inner_product_with(std::plus<>{}, std::multiplies<>{}, 0, xs, ys), 32);
+    const auto zs = fplus::numbers<int>(0, 100);
+    REQUIRE_EQ(fplus::inner_product(1, zs, zs), 328351);
+    const std::vector<double> ds = { 0.5, 1.5, 2.0, 4.0, 1.0, 2.0, 3.0, 4.0, 5.0 };
+    REQUIRE_EQ(fplus::inner_product(1.0, ds, ds), 78.5);
+    std::vector<float> fs(16, 1.0f);
+    fs[0] = 1e8f;
+    fs[8] = -1e8f;
+    const std::vector<float> ones(16, 1.0f);
+    REQUIRE_EQ(fplus::inner_product(0.0f, fs, ones), 14.0f);
+    REQUIRE_EQ(fplus::inner_product_with(std::plus<float>(),
+        std::multiplies<float>(), 0.0f, fs, ones), 7.0f);
 }
 
 TEST_CASE("generate_test, numbers")
@@ -0,0 +1,100 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define FPLUS_INSTRUMENT
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include <fplus/fplus.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+FPLUS_INSTRUMENT_DEFINE_ALLOCATION_HOOKS
+
+namespace {
+    typedef std::vector<int> IntVector;
+
+    bool is_odd_int(int x)
+    {
+        return x % 2 != 0;
+    }
+
+    fplus::instrument::call_stats stats_of(const std::string& name)
+    {
+        for (const auto& entry : fplus::instrument::stats())
+        {
+            if (entry.first == name)
+                return entry.second;
+        }
+        return fplus::instrument::call_stats();
+    }
+}
+
+TEST_CASE("instrument_test, counts_calls")
+{
+    using namespace fplus;
+    instrument::reset();
+    const IntVector xs = numbers(0, 100);
+    const auto ys = fwd::apply(xs,
+        fwd::transform(square<int>),
+        fwd::drop_if(is_odd_int),
+        fwd::reverse());
+    REQUIRE_EQ(ys.size(), 50);
+
+    const auto transform_stats = stats_of("transform");
+    REQUIRE_EQ(transform_stats.calls, 1);
+    REQUIRE_EQ(transform_stats.elements, 100);
+    REQUIRE_EQ(transform_stats.elements_copied, 100);
+    REQUIRE_EQ(transform_stats.elements_moved, 0);
+    REQUIRE_EQ(transform_stats.allocations, 1);
+    REQUIRE_EQ(transform_stats.bytes_allocated, 100 * sizeof(int));
+
+    const auto drop_if_stats = stats_of("drop_if");
+    REQUIRE_EQ(drop_if_stats.calls, 1);
+    REQUIRE_EQ(drop_if_stats.elements_moved, 100);
+    REQUIRE_EQ(drop_if_stats.allocations, 0);
+
+    // drop_if is implemented using keep_if.
+    REQUIRE_EQ(stats_of("keep_if").calls, 1);
+
+    REQUIRE_EQ(stats_of("reverse").elements_moved, 50);
+
+    instrument::reset();
+    REQUIRE(instrument::stats().empty());
+}
+
+TEST_CASE("instrument_test, report")
+{
+    using namespace fplus;
+    instrument::reset();
+    sort(IntVector({3, 1, 2}));
+    sort(IntVector({4, 1}));
+    const std::string table = instrument::report_table();
+    REQUIRE(is_prefix_of(std::string("function"), table));
+    REQUIRE(is_infix_of(std::string("sort"), table));
+    const std::string json = instrument::report_json();
+    REQUIRE(is_infix_of(std::string(
+        "{\"function\":\"sort\",\"calls\":2,\"elements\":5,"
+        "\"allocations\":0,\"bytes_allocated\":0,"
+        "\"elements_copied\":0,\"elements_moved\":5,"), json));
+}
+
+TEST_CASE("instrument_test, counts_after_reset")
+{
+    using namespace fplus;
+    instrument::reset();
+    for (int i = 0; i < 3; ++i)
+    {
+        keep_if(is_odd_int, std::list<int>({1, 2, 3, 4}));
+    }
+    REQUIRE_EQ(stats_of("keep_if").calls, 3);
+    REQUIRE_EQ(stats_of("keep_if").elements, 12);
+    instrument::reset();
+    REQUIRE(instrument::stats().empty());
+    keep_if(is_odd_int, std::list<int>({1, 2, 3}));
+    REQUIRE_EQ(stats_of("keep_if").calls, 1);
+    REQUIRE_EQ(stats_of("keep_if").elements, 3);
+}
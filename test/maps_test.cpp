@@ -169,6 +169,56 @@ TEST_CASE("maps_test, map functions")
     REQUIRE_EQ(map_union(union_map_1, union_map_2), union_map_res);
     REQUIRE_EQ(map_union_with(append<std::string>, union_map_1, union_map_2), union_map_with_res);
 
+    typedef std::unordered_map<int, std::string> IntStringUnorderedMap;
+    const IntStringUnorderedMap union_umap_1 = {{0, "a"}, {1, "b"}};
+    const IntStringUnorderedMap union_umap_2 = {{0, "c"}, {2, "d"}};
+    REQUIRE_EQ(map_union(union_umap_1, union_umap_2),
+        IntStringUnorderedMap({{0, "a"}, {1, "b"}, {2, "d"}}));
+    REQUIRE_EQ(map_union_with(append<std::string>, union_umap_1, union_umap_2),
+        IntStringUnorderedMap({{0, "ac"}, {1, "b"}, {2, "d"}}));
+
+    struct point { int x; int y; };
+    struct point_hash
+    {
+        std::size_t operator()(const point& p) const
+        {
+            return std::hash<int>()(p.x * 31 + p.y);
+        }
+    };
+    struct point_eq
+    {
+        bool operator()(const point& a, const point& b) const
+        {
+            return a.x == b.x && a.y == b.y;
+        }
+    };
+    typedef std::unordered_map<point, int, point_hash, point_eq> PointIntMap;
+    const auto point_union = map_union_with(std::plus<int>(),
+        PointIntMap({{{0, 1}, 1}, {{1, 0}, 2}}),
+        PointIntMap({{{0, 1}, 3}, {{2, 2}, 4}}));
+    REQUIRE_EQ(point_union.size(), 3);
+    REQUIRE_EQ(point_union.at({0, 1}), 4);
+    REQUIRE_EQ(point_union.at({2, 2}), 4);
+
+    typedef std::map<int, std::string, std::greater<int>> IntStringDescMap;
+    const auto desc_union = map_union(
+        IntStringDescMap({{0, "a"}, {2, "b"}}),
+        IntStringDescMap({{1, "c"}, {2, "d"}}));
+    REQUIRE_EQ(desc_union,
+        IntStringDescMap({{2, "b"}, {1, "c"}, {0, "a"}}));
+    REQUIRE_EQ(desc_union.begin()->first, 2);
+
+    typedef std::map<int, int> IntIntMap;
+    const auto evens = pairs_to_map<IntIntMap>(zip(
+        numbers_step(0, 100000, 2), replicate(50000, 1)));
+    const auto threes = pairs_to_map<IntIntMap>(zip(
+        numbers_step(0, 100000, 3), replicate(33334, 2)));
+    const auto union_counts = map_union_with(std::plus<int>(), evens, threes);
+    REQUIRE_EQ(union_counts.size(), 66667);
+    REQUIRE_EQ(union_counts.at(6), 3);
+    REQUIRE_EQ(union_counts.at(9), 2);
+    REQUIRE_EQ(union_counts.at(99998), 1);
+
     typedef std::map<std::string::value_type, int> CharIntMap;
     CharIntMap charIntMap = {{'a', 1}, {'b', 2}, {'A', 3}, {'C', 4}};
     const auto is_upper = [](std::string::value_type c) -> bool
@@ -190,4 +240,56 @@ TEST_CASE("maps_test, map functions")
     REQUIRE_EQ(
         map_pluck('a', CharIntMaps({{{'a',1}, {'b',2}}, {{'a',3}}, {{'c',4}}})),
         MaybeInts({1, 3, {}}));
-}
\ No newline at end of file
+}
+
+TEST_CASE("maps_test, flat_map")
+{
+    using namespace fplus;
+    typedef flat_map<int, std::string> IntStringFlatMap;
+    typedef std::pair<int, std::string> IntStringPair;
+    typedef std::vector<IntStringPair> IntStringPairs;
+    const IntStringFlatMap dict = pairs_to_map<IntStringFlatMap>(
+        IntStringPairs({{2, "c"}, {0, "a"}, {1, "b"}, {0, "x"}}));
+    REQUIRE_EQ(dict, IntStringFlatMap({{0, "a"}, {1, "b"}, {2, "c"}}));
+    REQUIRE_EQ(map_to_pairs(dict),
+        IntStringPairs({{0, "a"}, {1, "b"}, {2, "c"}}));
+    REQUIRE_EQ(get_from_map(dict, 1), just<std::string>("b"));
+    REQUIRE_EQ(get_from_map(dict, 3), nothing<std::string>());
+    REQUIRE(map_contains(dict, 2));
+    REQUIRE_FALSE(map_contains(dict, -1));
+    const auto is_one = [](int x) { return x == 1; };
+    REQUIRE_EQ(map_keep_if(is_one, dict), IntStringFlatMap({{1, "b"}}));
+    REQUIRE_EQ(map_drop_if(is_one, dict),
+        IntStringFlatMap({{0, "a"}, {2, "c"}}));
+    REQUIRE_EQ(map_union_with(append<std::string>, dict,
+            IntStringFlatMap({{0, "d"}, {3, "e"}})),
+        IntStringFlatMap({{0, "ad"}, {1, "b"}, {2, "c"}, {3, "e"}}));
+    REQUIRE_EQ(transform_map_values(size_of_cont<std::string>, dict),
+        flat_map<int, std::size_t>({{0, 1}, {1, 1}, {2, 1}}));
+    const auto created =
+        create_map<IntVector, std::vector<std::string>, int, std::string,
+            IntStringFlatMap>(
+                IntVector({1, 0}), std::vector<std::string>({"b", "a"}));
+    REQUIRE_EQ(created, IntStringFlatMap({{0, "a"}, {1, "b"}}));
+
+    typedef flat_map<int, std::vector<std::string>> IntStringsFlatMap;
+    const auto grouped = pairs_to_map_grouped<IntStringPairs, int, std::string,
+        IntStringsFlatMap>(IntStringPairs({{1, "b"}, {0, "a"}, {1, "c"}}));
+    REQUIRE_EQ(grouped, IntStringsFlatMap({{0, {"a"}}, {1, {"b", "c"}}}));
+
+    typedef flat_map<int, std::size_t> IntSizeFlatMap;
+    const auto counts = count_occurrences<IntVector, IntSizeFlatMap>(
+        IntVector({3, 1, 3, 2, 3, 1}));
+    REQUIRE_EQ(counts, IntSizeFlatMap({{1, 2}, {2, 1}, {3, 3}}));
+
+    IntStringFlatMap built;
+    built[5] = "f";
+    built[1] = "b";
+    built[3] = "d";
+    REQUIRE_EQ(built, IntStringFlatMap({{1, "b"}, {3, "d"}, {5, "f"}}));
+    REQUIRE_EQ(built.at(3), "d");
+    built.at(3) = "e";
+    REQUIRE_EQ(built.at(3), "e");
+    static_assert(std::is_const<std::remove_reference_t<
+        decltype(*built.begin())>>::value, "Keys must not be changeable.");
+}
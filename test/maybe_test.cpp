@@ -7,6 +7,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <list>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace {
@@ -185,6 +188,22 @@ TEST_CASE("maybe_test, transform_and_keep_justs")
     REQUIRE_EQ(transform_and_concat(
             bind_1st_of_2(replicate<int>, std::size_t(3)), Ints{ 1,2 })
            , Ints({ 1,1,1,2,2,2 }));
+
+    const auto to_long_word = [](int n) -> maybe<std::string>
+    {
+        if (n < 0)
+            return nothing<std::string>();
+        return just(std::string(static_cast<std::size_t>(n), 'x'));
+    };
+    REQUIRE_EQ(transform_and_keep_justs(to_long_word, std::list<int>{3, -1, 20})
+           , std::list<std::string>({"xxx", std::string(20, 'x')}));
+
+    const std::vector<Ints> xss = {{1, 2}, {}, {3}};
+    REQUIRE_EQ(transform_and_concat(
+            [&xss](std::size_t i) -> const Ints& { return xss[i]; },
+            std::vector<std::size_t>{0, 1, 2, 0})
+           , Ints({1, 2, 3, 1, 2}));
+    REQUIRE_EQ(xss, std::vector<Ints>({{1, 2}, {}, {3}}));
 }
 
 TEST_CASE("maybe_test, show_maybe")
@@ -219,6 +238,31 @@ TEST_CASE("maybe_test, copy")
     REQUIRE_EQ(maybe_4_copy_2, just<int>(4));
 }
 
+TEST_CASE("maybe_test, move")
+{
+    using namespace fplus;
+    struct throwing_move
+    {
+        throwing_move() = default;
+        throwing_move(const throwing_move&) = default;
+        throwing_move(throwing_move&&) noexcept(false) {}
+    };
+    static_assert(
+        std::is_nothrow_move_constructible<maybe<std::string>>::value,
+        "maybe<std::string> should be nothrow move constructible");
+    static_assert(
+        !std::is_nothrow_move_constructible<maybe<throwing_move>>::value,
+        "maybe<throwing_move> should not be nothrow move constructible");
+
+    // Growing the vector has to move the strings instead of copying them.
+    std::vector<maybe<std::string>> xs;
+    xs.push_back(just(std::string(100, 'x')));
+    const char* const data = xs.front().unsafe_get_just().data();
+    for (std::size_t i = 0; i < 100; ++i)
+        xs.push_back(nothing<std::string>());
+    REQUIRE(xs.front().unsafe_get_just().data() == data);
+}
+
 TEST_CASE("maybe_test, flatten")
 {
     using namespace fplus;
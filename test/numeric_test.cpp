@@ -427,6 +427,14 @@ TEST_CASE("numeric_test, normalize")
     REQUIRE_EQ(normalize_mean_stddev(3.0f, 2.0f, xs2), Floats({1, 5}));
     REQUIRE_EQ(standardize(xs3), Floats({-1, 1}));
 
+    REQUIRE_EQ(normalize_min_max(0.0, 8.0, Doubles({3, 1, 9, 5, 7, 2, 4, 6, 8, 1})),
+        Doubles({2, 0, 8, 4, 6, 1, 3, 5, 7, 0}));
+
+    const Ints ints = {1, 2, 3, 4, 5, 6, 7, 8};
+    REQUIRE_EQ(normalize_mean_stddev(0, 1, ints),
+        Ints({-1, -1, 0, 0, 0, 1, 1, 2}));
+    REQUIRE_EQ(normalize_mean_stddev(0, 5, ints),
+        Ints({-7, -5, -2, 0, 2, 5, 7, 10}));
 }
 
 TEST_CASE("numeric_test, winsorize")
@@ -443,6 +451,8 @@ TEST_CASE("numeric_test, winsorize")
     REQUIRE_EQ(winsorize(0.1, Doubles({4,4,4,3,8,4,6,4,3,4})), Doubles({3,3,4,4,4,4,4,4,6,6}));
     REQUIRE_EQ(winsorize(0, Doubles({1,3,4,4,4,4,4,4,6,8})), Doubles({1,3,4,4,4,4,4,4,6,8}));
 
+    REQUIRE_EQ(winsorize(0.2, std::list<int>({9,1,8,2,7,3,6,4,5,0})), std::list<int>({2,2,2,3,4,5,6,7,7,7}));
+    REQUIRE_EQ(winsorize(0.5, std::vector<int>({9,1,8,2,7,3,6,4,5,0})), std::vector<int>(10, 4));
     const auto median_result = winsorize(0.6, Doubles({1,2}));
     REQUIRE_EQ(median_result.size(), 2);
     REQUIRE(fplus::is_in_interval_around(0.001, 1.5, median_result[0]));
@@ -464,6 +474,15 @@ TEST_CASE("numeric_test, histogram")
     const bins result1 = {{{0, 4}, 2}, {{4, 5}, 1}, {{6, 8}, 2}};
 
     REQUIRE_EQ(histogram_using_intervals(intervals1, xs), result1);
+    REQUIRE_EQ(histogram_using_intervals_parallelly(intervals1, xs), result1);
+
+    const intervals intervals2 = {{6,8}, {0,4}, {3,6}};
+    const bins result2 = {{{6, 8}, 2}, {{0, 4}, 2}, {{3, 6}, 2}};
+    REQUIRE_EQ(histogram_using_intervals(intervals2, xs), result2);
+
+    const intervals intervals3 = {{0,5}, {1,6}, {5,5}, {5,9}};
+    const bins result3 = {{{0, 5}, 3}, {{1, 6}, 3}, {{5, 5}, 0}, {{5, 9}, 4}};
+    REQUIRE_EQ(histogram_using_intervals(intervals3, xs), result3);
 }
 
 TEST_CASE("numeric_test, generate_consecutive_intervals")
@@ -490,6 +509,20 @@ TEST_CASE("numeric_test, histogram_intervals")
     const bins result1 = {{1, 2}, {3, 0}, {5, 2}, {7, 1}};
 
     REQUIRE_EQ(histogram(1, 2, 4, xs), result1);
+    REQUIRE_EQ(histogram_parallelly(1, 2, 4, xs), result1);
+    REQUIRE_EQ(histogram(1, 2, 4, ints({-5, -1, 0, 9, 10, 100})),
+        bins({{1, 1}, {3, 0}, {5, 0}, {7, 0}}));
+
+    const auto ys = transform([](int x) { return 0.01 * x - 1.0; },
+        numbers<int>(0, 300000));
+    const auto intervals = generate_consecutive_intervals(0.0, 0.1, 9);
+    const auto histo = histogram(0.05, 0.1, 9, ys);
+    const auto histo_intervals = histogram_using_intervals(intervals, ys);
+    REQUIRE_EQ(histogram_parallelly(0.05, 0.1, 9, ys), histo);
+    REQUIRE_EQ(transform([](const auto& bin) { return bin.second; }, histo),
+        transform([](const auto& bin) { return bin.second; }, histo_intervals));
+    REQUIRE_EQ(sum(transform([](const auto& bin) { return bin.second; }, histo)),
+        90);
 }
 
 TEST_CASE("numeric_test, modulo_chain")
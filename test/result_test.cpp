@@ -7,6 +7,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <string>
 #include <vector>
 
 namespace {
@@ -178,6 +179,18 @@ TEST_CASE("result_test, transform_and_keep_oks")
     REQUIRE_EQ(transform_and_concat(
             bind_1st_of_2(replicate<int>, std::size_t(3)), Ints{ 1,2 })
            , Ints({ 1,1,1,2,2,2 }));
+
+    typedef std::vector<std::string> Strings;
+    const auto parse_digits = [](const std::string& s)
+        -> result<std::string, std::string>
+    {
+        if (s.find_first_not_of("0123456789") == std::string::npos)
+            return ok<std::string, std::string>(s);
+        return error<std::string, std::string>("no number: " + s);
+    };
+    REQUIRE_EQ(transform_and_keep_oks(parse_digits,
+                Strings({"12", "a", "", "345"}))
+           , Strings({"12", "", "345"}));
 }
 
 TEST_CASE("result_test, show_result")
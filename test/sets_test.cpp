@@ -7,6 +7,8 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <list>
+#include <set>
 
 
 TEST_CASE("set_test, set functions")
@@ -24,6 +26,8 @@ TEST_CASE("set_test, set functions")
     REQUIRE_FALSE(set_includes(IntSet({0,1,2,3}), IntSet({2,3,4,5})));
     REQUIRE_EQ(set_merge(IntSet({0,1,2,3}), IntSet({2,3,4,5})), IntSet({0,1,2,3,4,5}));
     REQUIRE_EQ(set_merge(IntSet({0,1,2,3}), IntSet({0,2})), IntSet({0,1,2,3}));
+    using IntMultiSet = std::multiset<int>;
+    REQUIRE_EQ(set_merge(IntMultiSet({1}), IntMultiSet({1})), IntMultiSet({1,1}));
     REQUIRE_EQ(set_intersection(IntSet({0,1,2,3}), IntSet({2,3,4,5})), IntSet({2,3}));
     REQUIRE_EQ(set_difference(IntSet({0,1,2,3}), IntSet({2,3,4,5})), IntSet({0,1}));
     REQUIRE_EQ(set_symmetric_difference(IntSet({0,1,2,3}), IntSet({2,3,4,5})), IntSet({0,1,4,5}));
@@ -50,3 +54,80 @@ TEST_CASE("set_test, set functions")
     REQUIRE(unordered_set_is_disjoint(IntUnordSet({0,1,3}), IntUnordSet({2,4})));
     REQUIRE_FALSE(unordered_set_is_disjoint(IntUnordSet({0,1,3}), IntUnordSet({2,1})));
 }
+
+TEST_CASE("set_test, sets_intersection")
+{
+    using namespace fplus;
+    using IntSet = std::set<int>;
+    using IntVector = std::vector<int>;
+    using IntUnordSet = std::unordered_set<int>;
+
+    REQUIRE_EQ(sets_intersection(std::vector<IntSet>({IntSet({1,2,3})})),
+        IntSet({1,2,3}));
+    REQUIRE_EQ(sets_intersection(std::vector<IntSet>(
+        {IntSet({0,1,2,3,4}), IntSet({}), IntSet({1})})), IntSet());
+    REQUIRE_EQ(sets_intersection(std::vector<IntVector>(
+        {IntVector({0,1,2,3,4,5,6,7,8,9}), IntVector({3,9}),
+            IntVector({2,3,4,9,10})})), IntVector({3,9}));
+    REQUIRE_EQ(unordered_sets_intersection(std::vector<IntUnordSet>(
+        {IntUnordSet({0,1,2,3,4}), IntUnordSet({3,1,7}),
+            IntUnordSet({1,3})})), IntUnordSet({1,3}));
+
+    const auto evens = numbers_step<int>(0, 1000000, 2);
+    const auto threes = numbers_step<int>(0, 1000000, 3);
+    const IntVector few = {-1, 6, 7, 12, 600000, 999996, 1000002};
+    REQUIRE_EQ(sets_intersection(std::vector<IntVector>({evens, few, threes})),
+        IntVector({6, 12, 600000, 999996}));
+    REQUIRE_EQ(size_of_cont(sets_intersection(
+        std::vector<IntVector>({evens, threes}))), 166667);
+
+    const auto evens_set = convert_container<IntSet>(evens);
+    const auto threes_set = convert_container<IntSet>(threes);
+    const auto few_set = convert_container<IntSet>(few);
+    REQUIRE_EQ(sets_intersection(
+            std::vector<IntSet>({evens_set, few_set, threes_set})),
+        IntSet({6, 12, 600000, 999996}));
+    REQUIRE_EQ(size_of_cont(sets_intersection(
+        std::vector<IntSet>({evens_set, threes_set}))), 166667);
+    using IntList = std::list<int>;
+    REQUIRE_EQ(sets_intersection(std::vector<IntList>(
+            {convert_container<IntList>(evens), IntList({-1, 6, 7, 12}),
+                convert_container<IntList>(threes)})),
+        IntList({6, 12}));
+}
+
+TEST_CASE("set_test, flat sets")
+{
+    using namespace fplus;
+    using IntVector = std::vector<int>;
+    const IntVector xs = {0, 1, 2, 3, 7};
+    const IntVector ys = {2, 3, 4, 5, 7};
+    REQUIRE_EQ(set_merge(xs, ys), IntVector({0, 1, 2, 2, 3, 3, 4, 5, 7, 7}));
+    REQUIRE_EQ(set_intersection(xs, ys), IntVector({2, 3, 7}));
+    REQUIRE_EQ(set_difference(xs, ys), IntVector({0, 1}));
+    REQUIRE_EQ(set_symmetric_difference(xs, ys), IntVector({0, 1, 4, 5}));
+    REQUIRE(set_includes(xs, IntVector({1, 7})));
+    REQUIRE(set_is_disjoint(xs, IntVector({4, 5})));
+}
+
+TEST_CASE("set_test, flat_set")
+{
+    using namespace fplus;
+    using IntFlatSet = flat_set<int>;
+    const IntFlatSet xs = {7, 3, 0, 1, 2, 3};
+    const IntFlatSet ys = {2, 3, 4, 5, 7};
+    REQUIRE_EQ(xs.size(), 5);
+    REQUIRE_EQ(xs.count(3), 1);
+    REQUIRE_EQ(xs.count(4), 0);
+    REQUIRE_EQ(set_merge(xs, ys), IntFlatSet({0, 1, 2, 3, 4, 5, 7}));
+    REQUIRE_EQ(set_intersection(xs, ys), IntFlatSet({2, 3, 7}));
+    REQUIRE_EQ(set_difference(xs, ys), IntFlatSet({0, 1}));
+    REQUIRE_EQ(set_symmetric_difference(xs, ys), IntFlatSet({0, 1, 4, 5}));
+    REQUIRE_EQ(sets_intersection(std::vector<IntFlatSet>({xs, ys, {3, 7, 9}})),
+        IntFlatSet({3, 7}));
+    REQUIRE(set_includes(xs, IntFlatSet({1, 7})));
+    REQUIRE(unordered_set_includes(xs, IntFlatSet({1, 7})));
+    REQUIRE(set_is_disjoint(xs, IntFlatSet({4, 5})));
+    REQUIRE_EQ(convert_container<IntFlatSet>(std::vector<int>({2, 1, 2})),
+        IntFlatSet({1, 2}));
+}
@@ -7,6 +7,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <clocale>
 
 namespace {
     typedef std::vector<int> IntVector;
@@ -87,3 +88,76 @@ TEST_CASE("show_test, show_float")
     REQUIRE_EQ(show_fill_right<int>(' ', 4, 3), "3   ");
     REQUIRE_EQ(show_fill_right<int>(' ', 4, 12345), "12345");
 }
+
+TEST_CASE("show_test, show_numbers_like_streams")
+{
+    using namespace fplus;
+    const auto stream_show = [](const auto& x) -> std::string
+    {
+        std::ostringstream ss;
+        ss << x;
+        return ss.str();
+    };
+    REQUIRE_EQ(show(0), "0");
+    REQUIRE_EQ(show(-42), "-42");
+    REQUIRE_EQ(show(std::numeric_limits<int>::min()),
+        stream_show(std::numeric_limits<int>::min()));
+    REQUIRE_EQ(show(std::numeric_limits<long long>::min()),
+        stream_show(std::numeric_limits<long long>::min()));
+    REQUIRE_EQ(show(std::numeric_limits<unsigned long long>::max()),
+        stream_show(std::numeric_limits<unsigned long long>::max()));
+    REQUIRE_EQ(show(static_cast<short>(-7)), "-7");
+    REQUIRE_EQ(show('a'), "a");
+    REQUIRE_EQ(show(true), "1");
+
+    const std::vector<double> doubles = {0.0, -0.0, 1.0, -2.5, 3.14159265,
+        1e-5, 123456.0, 1234567.0, 1e100, -1e-300,
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::infinity()};
+    for (double x : doubles)
+    {
+        REQUIRE_EQ(show(x), stream_show(x));
+        REQUIRE_EQ(show(static_cast<float>(x)),
+            stream_show(static_cast<float>(x)));
+        REQUIRE_EQ(show(static_cast<long double>(x)),
+            stream_show(static_cast<long double>(x)));
+    }
+    std::vector<std::string> doubles_shown;
+    for (double x : doubles)
+    {
+        doubles_shown.push_back(stream_show(x));
+    }
+    REQUIRE_EQ(show(doubles),
+        "[" + join(std::string(", "), doubles_shown) + "]");
+
+    REQUIRE_EQ(show(std::vector<std::pair<int, double>>({{1, 0.5}, {-2, 2}})),
+        "[(1, 0.5), (-2, 2)]");
+    REQUIRE_EQ(show_cont(std::vector<char>({'a', 'b'})), "[a, b]");
+    REQUIRE_EQ(show_cont_with_frame_and_newlines(", ", "{", "}",
+        std::vector<int>({1, 2, 3}), 1), "{1, \n 2, \n 3}");
+    REQUIRE_EQ(show_cont(std::vector<int>()), "[]");
+    REQUIRE_EQ(show_float<float>(2, 2, 1.5f), "01.50");
+    REQUIRE_EQ(show_float<double>(0, 0, 2.5), "2");
+    REQUIRE_EQ(show_float<double>(1, 2, 1e20), "100000000000000000000.00");
+}
+
+TEST_CASE("show_test, show_numbers_with_c_locale")
+{
+    using namespace fplus;
+    // Only the C locale uses a comma as the decimal point here,
+    // while the C++ global locale stays the classic one.
+    const std::vector<std::string> names = {
+        "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR"};
+    const auto set = find_first_by([](const std::string& name)
+        {
+            return std::setlocale(LC_NUMERIC, name.c_str()) != nullptr;
+        }, names);
+    if (is_nothing(set))
+        return;
+    std::ostringstream ss;
+    ss << -2.5;
+    const std::string shown = show(-2.5);
+    std::setlocale(LC_NUMERIC, "C");
+    REQUIRE_EQ(shown, ss.str());
+    REQUIRE_EQ(shown, "-2.5");
+}
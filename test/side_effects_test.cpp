@@ -7,6 +7,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <fplus/fplus.hpp>
+#include <cctype>
 #include <vector>
 
 TEST_CASE("side_effects_test, execute")
@@ -78,3 +79,228 @@ TEST_CASE("side_effects_test, execute_parallelly_atomic")
     execute_parallelly(replicate(4, inc_atomic_int_return_true))();
     REQUIRE_EQ(atomic_int.load(), 4);
 }
+
+TEST_CASE("side_effects_test, read_file_view")
+{
+    using namespace fplus;
+    const std::string filename = "side_effects_test_read_file_view.txt";
+    const std::string content = "Hello,\r\nworld!\n\rbye\n";
+    REQUIRE(write_text_file(filename, content)());
+
+    const auto view = read_text_file_view(filename)();
+    REQUIRE_EQ(view.size(), content.size());
+    REQUIRE_EQ(convert_container<std::string>(view), content);
+    REQUIRE_EQ(count('\n', view), 3);
+    const auto is_letter = [](char c) { return std::isalpha(c) != 0; };
+    REQUIRE_EQ(keep_if(is_letter, view),
+        std::vector<char>({'H', 'e', 'l', 'l', 'o', 'w', 'o', 'r', 'l', 'd',
+            'b', 'y', 'e'}));
+    REQUIRE_EQ(keep_if(is_letter, read_text_file_view(filename)()),
+        keep_if(is_letter, std::vector<char>(content.begin(), content.end())));
+    const auto to_code = [](char c) { return static_cast<int>(c); };
+    REQUIRE_EQ(transform(to_code, view),
+        transform_convert<std::vector<int>>(to_code, content));
+    REQUIRE_EQ(materialize(view),
+        std::vector<char>(content.begin(), content.end()));
+    REQUIRE_EQ(read_text_file(filename)(), content);
+    REQUIRE_EQ(read_text_file_lines(false, filename)(),
+        split_lines(false, content));
+    REQUIRE_EQ(read_text_file_lines(true, filename)(),
+        split_lines(true, content));
+
+    const auto binary_view = read_binary_file_view(filename)();
+    REQUIRE_EQ(sum(convert_elems<std::size_t>(binary_view)),
+        sum(convert_elems<std::size_t>(read_binary_file(filename)())));
+
+    std::remove(filename.c_str());
+    REQUIRE(is_nothing(read_text_file_view_maybe(filename)()));
+    REQUIRE(is_nothing(read_binary_file_maybe(filename)()));
+    REQUIRE(read_text_file_view(filename)().empty());
+}
+
+TEST_CASE("side_effects_test, read_text_file_lines")
+{
+    using namespace fplus;
+    const std::string filename = "side_effects_test_read_text_file_lines.txt";
+    const std::vector<std::string> contents = {"", "\n", "\n\n", "a", "a\n",
+        "\na", "a\r\n\r\nb\r", "a\r\r\nb", "\r\n\r"};
+    for (const auto& content : contents)
+    {
+        REQUIRE(write_text_file(filename, content)());
+        REQUIRE_EQ(read_text_file_lines(false, filename)(),
+            split_lines(false, content));
+        REQUIRE_EQ(read_text_file_lines(true, filename)(),
+            split_lines(true, content));
+        for (std::size_t buffer_size :
+            std::vector<std::size_t>({1, 2, 3, 1024}))
+        {
+            for (bool allow_empty : {false, true})
+            {
+                std::vector<std::string> lines;
+                for (const auto& line : read_text_file_lines_lazy(
+                        allow_empty, filename, buffer_size)())
+                {
+                    lines.push_back(line);
+                }
+                REQUIRE_EQ(lines, split_lines(allow_empty, content));
+            }
+        }
+    }
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("side_effects_test, read_text_file_lines_lazy")
+{
+    using namespace fplus;
+    const std::string filename = "side_effects_test_read_text_file_lines_lazy.txt";
+    REQUIRE(write_text_file(filename, "a\nbb\n\nccc\n")());
+    const auto add_length = [](std::size_t acc, const std::string& line)
+    {
+        return acc + line.size();
+    };
+    REQUIRE_EQ(fold_left(add_length, std::size_t(0),
+        read_text_file_lines_lazy(false, filename)()), 6);
+    REQUIRE(all_by(is_not_empty<std::string>,
+        read_text_file_lines_lazy(false, filename)()));
+    REQUIRE_FALSE(all_by(is_not_empty<std::string>,
+        read_text_file_lines_lazy(true, filename)()));
+    typedef std::vector<std::string> Strings;
+    REQUIRE_EQ(transform(size_of_cont<std::string>,
+            read_text_file_lines_lazy(true, filename)()),
+        std::vector<std::size_t>({1, 2, 0, 3, 0}));
+    REQUIRE_EQ(keep_if(is_not_empty<std::string>,
+            read_text_file_lines_lazy(true, filename)()),
+        Strings({"a", "bb", "ccc"}));
+    REQUIRE_EQ(materialize(read_text_file_lines_lazy(false, filename)()),
+        Strings({"a", "bb", "ccc"}));
+    std::remove(filename.c_str());
+    REQUIRE(is_nothing(read_text_file_lines_lazy_maybe(false, filename)()));
+    const auto no_lines = read_text_file_lines_lazy(false, filename)();
+    REQUIRE(no_lines.begin() == no_lines.end());
+}
+
+#ifdef __linux__
+TEST_CASE("side_effects_test, read_text_file_lines_lazy_error")
+{
+    using namespace fplus;
+    // A directory can be opened, but reading from it fails.
+    const auto lines = read_text_file_lines_lazy_maybe(false, ".")();
+    REQUIRE(is_just(lines));
+    std::string thrown_str;
+    try
+    {
+        lines.unsafe_get_just().begin();
+    }
+    catch (const std::ios_base::failure& e)
+    {
+        thrown_str = e.what();
+    }
+    REQUIRE_FALSE(thrown_str.empty());
+}
+#endif
+
+#ifdef __linux__
+TEST_CASE("side_effects_test, read_file_view_special_file")
+{
+    using namespace fplus;
+    // Files in /proc report a size of zero, so they are not memory-mapped.
+    const std::string filename = "/proc/self/cmdline";
+    std::ifstream file(filename, std::ios::binary);
+    const std::string expected(std::istreambuf_iterator<char>(file),
+        (std::istreambuf_iterator<char>()));
+    REQUIRE_FALSE(expected.empty());
+    REQUIRE_EQ(convert_container<std::string>(
+        read_text_file_view(filename)()), expected);
+}
+#endif
+
+TEST_CASE("side_effects_test, write_files")
+{
+    using namespace fplus;
+    const std::string filename = "side_effects_test_write_files.txt";
+    const std::vector<std::string> lines = {"foo", "", std::string(100, 'x'),
+        "bar"};
+    for (bool trailing_newline : {false, true})
+    {
+        const std::string expected =
+            join(std::string("\n"), lines) + (trailing_newline ? "\n" : "");
+        REQUIRE(write_text_file_lines(trailing_newline, filename, lines)());
+        REQUIRE_EQ(read_text_file(filename)(), expected);
+        auto lines_to_move = lines;
+        const auto write_moved_lines = write_text_file_lines(
+            trailing_newline, filename, std::move(lines_to_move));
+        REQUIRE(lines_to_move.empty());
+        REQUIRE(write_moved_lines());
+        REQUIRE_EQ(read_text_file(filename)(), expected);
+        for (std::size_t buffer_size :
+            std::vector<std::size_t>({1, 3, 50, 1000}))
+        {
+            file_write_options options;
+            options.buffer_size = buffer_size;
+            options.preallocate = true;
+            options.sync = buffer_size == 1000;
+            REQUIRE(write_text_file_lines_with_options(options,
+                trailing_newline, filename, lines)());
+            REQUIRE_EQ(read_text_file(filename)(), expected);
+            REQUIRE(write_text_file_with_options(options,
+                filename, expected)());
+            REQUIRE_EQ(read_text_file(filename)(), expected);
+        }
+    }
+    REQUIRE(write_text_file_lines(true, filename, {})());
+    REQUIRE_EQ(read_text_file(filename)(), "\n");
+
+    const std::vector<std::uint8_t> bytes = {0, 1, 2, 255, 10, 13, 0};
+    REQUIRE(write_binary_file(filename, bytes)());
+    REQUIRE_EQ(read_binary_file(filename)(), bytes);
+    REQUIRE(write_binary_file(filename, {})());
+    REQUIRE(read_binary_file(filename)().empty());
+    std::remove(filename.c_str());
+
+    REQUIRE_FALSE(write_text_file("non_existing_dir/file.txt", "foo")());
+    REQUIRE_FALSE(write_text_file_lines(false, "non_existing_dir/file.txt",
+        lines)());
+}
+
+TEST_CASE("side_effects_test, read_files")
+{
+    using namespace fplus;
+    const std::vector<std::string> contents = {"foo", "", "bar\nbaz",
+        std::string(1000, 'x'), "qux"};
+    std::vector<std::string> filenames;
+    for (std::size_t i = 0; i < contents.size(); ++i)
+    {
+        filenames.push_back(
+            "side_effects_test_read_files_" + show(i) + ".txt");
+        REQUIRE(write_text_file(filenames.back(), contents[i])());
+    }
+    filenames.push_back("side_effects_test_read_files_missing.txt");
+
+    std::vector<maybe<std::string>> expected_texts;
+    std::vector<maybe<std::vector<std::uint8_t>>> expected_binaries;
+    for (const auto& filename : filenames)
+    {
+        expected_texts.push_back(read_text_file_maybe(filename)());
+        expected_binaries.push_back(read_binary_file_maybe(filename)());
+    }
+    REQUIRE(is_just(expected_texts[1]));
+    REQUIRE(is_nothing(expected_binaries[1]));
+    REQUIRE(is_nothing(expected_texts.back()));
+
+    for (std::size_t n_threads : std::vector<std::size_t>({0, 1, 3, 100}))
+    {
+        for (std::size_t max_bytes : std::vector<std::size_t>({0, 1, 100}))
+        {
+            REQUIRE_EQ(read_text_files(n_threads, max_bytes, filenames)(),
+                expected_texts);
+            REQUIRE_EQ(read_binary_files(n_threads, max_bytes, filenames)(),
+                expected_binaries);
+        }
+    }
+    REQUIRE(read_text_files(2, 0, std::vector<std::string>())().empty());
+
+    for (const auto& filename : filenames)
+    {
+        std::remove(filename.c_str());
+    }
+}
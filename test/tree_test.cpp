@@ -16,6 +16,19 @@ namespace {
     typedef fplus::tree<IntPair> IntPairTree;
     typedef fplus::tree<int> IntTree;
     typedef std::vector<IntPairTree> IntPairTreeVector;
+
+    // Ordered only by key, but equal only if the payload matches too.
+    struct keyed
+    {
+        int key;
+        int payload;
+    };
+    bool operator<(const keyed& a, const keyed& b) { return a.key < b.key; }
+    bool operator==(const keyed& a, const keyed& b)
+    {
+        return a.key == b.key && a.payload == b.payload;
+    }
+    bool operator!=(const keyed& a, const keyed& b) { return !(a == b); }
 }
 
 TEST_CASE("tree_test, are_trees_equal")
@@ -33,6 +46,53 @@ TEST_CASE("tree_test, are_trees_equal")
             {{0, 4}, {}}}};
 
     REQUIRE(are_trees_equal(a, b));
+
+    const IntTree c =
+        {{0}, {
+            {{1}, {{{2}, {}}, {{3}, {{{4}, {}}}}}},
+            {{1}, {{{3}, {}}, {{2}, {}}}}}};
+    const IntTree d =
+        {{0}, {
+            {{1}, {{{2}, {}}, {{3}, {}}}},
+            {{1}, {{{3}, {{{4}, {}}}}, {{2}, {}}}}}};
+    const IntTree e =
+        {{0}, {
+            {{1}, {{{2}, {{{4}, {}}}}, {{3}, {}}}},
+            {{1}, {{{3}, {}}, {{2}, {}}}}}};
+    const IntTree f =
+        {{0}, {
+            {{1}, {{{2}, {}}, {{3}, {}}}},
+            {{1}, {{{3}, {}}, {{2}, {}}}}}};
+    REQUIRE(are_trees_equal(c, d));
+    REQUIRE(are_trees_equal(d, c));
+    REQUIRE_FALSE(are_trees_equal(c, e));
+    REQUIRE_FALSE(are_trees_equal(e, c));
+    REQUIRE_FALSE(are_trees_equal(c, f));
+    REQUIRE_FALSE(are_trees_equal(c, IntTree({0}, {})));
+    IntTree c_copy = f;
+    c_copy = c;
+    REQUIRE_EQ(tree_to_flat_tree(c_copy).values(),
+        tree_to_flat_tree(c).values());
+    REQUIRE_EQ(flatten_tree_depth_first(IntTree(c)),
+        flatten_tree_depth_first(c));
+}
+
+TEST_CASE("tree_test, are_trees_equal_equivalent_values")
+{
+    using namespace fplus;
+    typedef tree<keyed> KeyedTree;
+    const KeyedTree p = {{2, 0}, {}};
+    const KeyedTree q = {{2, 1}, {}};
+    const KeyedTree pq = {{1, 0}, {p, q}};
+    const KeyedTree qp = {{1, 0}, {q, p}};
+    const KeyedTree pp = {{1, 0}, {p, p}};
+    REQUIRE(are_trees_equal(pq, qp));
+    REQUIRE_FALSE(are_trees_equal(pq, pp));
+    REQUIRE_FALSE(are_trees_equal(pp, pq));
+    REQUIRE_FALSE(are_trees_equal(KeyedTree({1, 0}, {p}),
+        KeyedTree({1, 0}, {q})));
+    REQUIRE_FALSE(are_trees_equal(KeyedTree({1, 0}, {p}),
+        KeyedTree({1, 1}, {p})));
 }
 
 TEST_CASE("tree_test, sequence_to_tree small")
@@ -111,6 +171,83 @@ TEST_CASE("tree_test, sequence_to_tree medium")
     REQUIRE(all(zip_with(are_trees_equal<IntPair>, result_1, result)));
 }
 
+TEST_CASE("tree_test, sequence_to_tree large")
+{
+    using namespace fplus;
+    // Nested intervals [i, 2000 - i), each one the parent of the next.
+    const auto elems = transform([](int i) -> IntPair
+        {
+            return {i, 2000 - i};
+        }, numbers(0, 1000));
+    const auto is_child_of = [](const IntPair& a, const IntPair& b) -> bool
+    {
+        return a.first >= b.first && a.second <= b.second;
+    };
+    const auto result = trees_from_sequence(is_child_of, reverse(elems));
+    REQUIRE_EQ(result.size(), 1);
+    REQUIRE_EQ(tree_depth(result.front()), 1000);
+    REQUIRE_EQ(flatten_tree_depth_first(result.front()), elems);
+}
+
+TEST_CASE("tree_test, sequence_to_tree_by_keys")
+{
+    using namespace fplus;
+    // (id, parent id), parent id 0 meaning no parent.
+    const IntPairVector elems = {
+        {4, 2},
+        {1, 0},
+        {2, 1},
+        {3, 1},
+        {5, 2},
+        {6, 0},
+        {7, 9}
+    };
+    const auto key_of = [](const IntPair& x) { return x.first; };
+    const auto parent_key_of = [](const IntPair& x) -> maybe<int>
+    {
+        return x.second == 0 ? nothing<int>() : just(x.second);
+    };
+    const auto result =
+        trees_from_sequence_by_keys(key_of, parent_key_of, elems);
+
+    const IntPairTreeVector expected = {
+        {{1, 0}, {
+            {{2, 1}, {
+                {{4, 2}, {}},
+                {{5, 2}, {}}
+            }},
+            {{3, 1}, {}}
+        }},
+        {{6, 0}, {}},
+        {{7, 9}, {}}
+    };
+    REQUIRE_EQ(result.size(), expected.size());
+    REQUIRE(all(zip_with(are_trees_equal<IntPair>, result, expected)));
+    REQUIRE_EQ(flatten_tree_depth_first(result.front()),
+        IntPairVector({{1, 0}, {2, 1}, {4, 2}, {5, 2}, {3, 1}}));
+
+    const IntPairVector cyclic = {{1, 3}, {2, 1}, {3, 2}, {4, 4}};
+    const auto result_cyclic =
+        trees_from_sequence_by_keys(key_of, parent_key_of, cyclic);
+    REQUIRE_EQ(result_cyclic.size(), 2);
+    REQUIRE_EQ(flatten_tree_depth_first(result_cyclic[0]),
+        IntPairVector({{1, 3}, {2, 1}, {3, 2}}));
+    REQUIRE_EQ(flatten_tree_depth_first(result_cyclic[1]),
+        IntPairVector({{4, 4}}));
+
+    // A binary tree of 200000 elements, given leaves first.
+    const auto heap = transform([](int i) -> IntPair
+        {
+            return {i, i / 2};
+        }, reverse(numbers(1, 200001)));
+    const auto result_heap =
+        trees_from_sequence_by_keys(key_of, parent_key_of, heap);
+    REQUIRE_EQ(result_heap.size(), 1);
+    REQUIRE_EQ(result_heap.front().value_, IntPair(1, 0));
+    REQUIRE_EQ(tree_size(result_heap.front()), 200000);
+    REQUIRE_EQ(tree_depth(result_heap.front()), 18);
+}
+
 TEST_CASE("tree_test, tree_depth")
 {
     const IntTree t =
@@ -182,3 +319,89 @@ TEST_CASE("tree_test, flatten_tree_breadth_first")
         }};
     REQUIRE_EQ(flatten_tree_breadth_first(t), IntVector({0,1,2,3,4,5,6,7,8}));
 }
+
+TEST_CASE("tree_test, flat_tree")
+{
+    using namespace fplus;
+    const IntTree t =
+        {{0}, {
+            {{1}, {
+                {{4}, {
+                }},
+                {{5}, {
+                    {{7}, {
+                    }},
+                    {{8}, {
+                    }}
+                }},
+                {{6}, {
+                }}
+            }},
+            {{2}, {
+            }},
+            {{3}, {
+            }}
+        }};
+    const auto ft = tree_to_flat_tree(t);
+    REQUIRE_EQ(ft.size(), 9);
+    REQUIRE_EQ(ft.values(), flatten_tree_depth_first(t));
+    REQUIRE_EQ(flatten_flat_tree_depth_first(ft),
+        IntVector({0,1,4,5,7,8,6,2,3}));
+    REQUIRE_EQ(flatten_flat_tree_breadth_first(ft),
+        flatten_tree_breadth_first(t));
+    REQUIRE_EQ(flat_tree_depth(ft), tree_depth(t));
+    REQUIRE_EQ(ft.child_idxs(0), std::vector<std::size_t>({1, 7, 8}));
+    REQUIRE_EQ(ft.child_idxs(3), std::vector<std::size_t>({4, 5}));
+    REQUIRE_EQ(ft.parent(4), just<std::size_t>(3));
+    REQUIRE_EQ(ft.parent(0), nothing<std::size_t>());
+    REQUIRE_EQ(ft.subtree_size(1), 6);
+    REQUIRE_EQ(ft.subtree_end(1), 7);
+    REQUIRE(are_trees_equal(flat_tree_to_tree(ft), t));
+
+    const auto sub = flat_subtree(3, ft);
+    REQUIRE_EQ(sub.values(), IntVector({5,7,8}));
+    REQUIRE_EQ(sub.parent(2), just<std::size_t>(0));
+    REQUIRE_EQ(flat_tree_depth(sub), 2);
+    REQUIRE_EQ(flat_tree_to_tree(sub).children_.size(), 2);
+}
+
+TEST_CASE("tree_test, flat_tree large")
+{
+    using namespace fplus;
+    IntVector xs(100000);
+    std::iota(std::begin(xs), std::end(xs), 0);
+    const auto trees = trees_from_sequence_by_keys(
+        identity<int>,
+        [](int x) { return x == 0 ? nothing<int>() : just((x - 1) / 3); },
+        xs);
+    REQUIRE_EQ(trees.size(), 1);
+    const auto ft = tree_to_flat_tree(trees.front());
+    REQUIRE_EQ(ft.size(), 100000);
+    REQUIRE_EQ(flat_tree_depth(ft), tree_depth(trees.front()));
+    REQUIRE_EQ(flatten_flat_tree_breadth_first(ft), xs);
+    REQUIRE_EQ(ft.values(), flatten_tree_depth_first(trees.front()));
+    REQUIRE_EQ(flatten_tree_breadth_first(flat_tree_to_tree(ft)), xs);
+}
+
+TEST_CASE("tree_test, deep chain")
+{
+    using namespace fplus;
+    IntVector xs(1000000);
+    std::iota(std::begin(xs), std::end(xs), 0);
+    const auto trees = trees_from_sequence_by_keys(
+        identity<int>,
+        [](int x) { return x == 0 ? nothing<int>() : just(x - 1); },
+        xs);
+    REQUIRE_EQ(trees.size(), 1);
+    REQUIRE_EQ(tree_depth(trees.front()), 1000000);
+    const auto ft = tree_to_flat_tree(trees.front());
+    REQUIRE_EQ(flat_tree_depth(ft), 1000000);
+    REQUIRE_EQ(ft.values(), xs);
+    const auto moved = tree_to_flat_tree(flat_tree_to_tree(ft));
+    REQUIRE_EQ(moved.values(), xs);
+    const IntTree copied = trees.front();
+    REQUIRE_EQ(tree_to_flat_tree(copied).values(), xs);
+    IntTree assigned = IntTree(0, {});
+    assigned = copied;
+    REQUIRE_EQ(tree_depth(assigned), 1000000);
+}